@@ -0,0 +1,52 @@
+#include "solver/equity/equity.h"
+#include "solver/utils/utils.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Times exact range-vs-range equity (every combo against every combo on every board, preflop and
+// on a flop), then exact against Monte Carlo equity for a preflop hand-vs-hand matchup. Pass a
+// thread count as the first argument (default: one per hardware thread).
+
+int main(const int argc, char** argv) {
+    const int num_threads = argc > 1 ? std::stoi(argv[1]) : 0;
+    const EquityCalculator calculator(num_threads);
+    const std::vector<double> any_two(Utils::NUM_COMBOS, 1.0);
+    const std::vector<double> tight = EquityCalculator::ParseRange(
+        "AA,KK,QQ,JJ,TT,99,AK,AQs,AJs,KQs");
+
+    struct Case {
+        std::string name, board;
+        const std::vector<double>& range1, & range2;
+    };
+    for (const Case& c: {
+             Case{"preflop, any two vs any two", "", any_two, any_two},
+             Case{"preflop, tight vs any two", "", tight, any_two},
+             Case{"flop, any two vs any two", "Ah7d2c", any_two, any_two},
+         }) {
+        const auto start = std::chrono::steady_clock::now();
+        const RangeEquity result = calculator.RangeVsRange(c.range1, c.range2,
+                                                           Utils::ParseCards(c.board));
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << c.name << ": equity " << result.total.GetEquity() << " in "
+                  << elapsed.count() << " s" << std::endl;
+    }
+
+    const std::vector<u32> hand1 = Utils::ParseCards("AhKh"), hand2 = Utils::ParseCards("9c9d");
+    auto start = std::chrono::steady_clock::now();
+    const double exact = calculator.HandVsHand(hand1, hand2).GetEquity();
+    const std::chrono::duration<double> exact_time = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    const MonteCarloResult estimate = calculator.EstimateHandVsHand(hand1, hand2);
+    const std::chrono::duration<double> estimate_time = std::chrono::steady_clock::now() - start;
+
+    std::cout << "AhKh vs 9c9d: exact " << exact << " in " << exact_time.count()
+              << " s, Monte Carlo " << estimate.result.GetEquity() << " +- " << estimate.error
+              << " in " << estimate_time.count() << " s" << std::endl;
+
+    return 0;
+}
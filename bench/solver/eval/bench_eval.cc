@@ -0,0 +1,57 @@
+#include "solver/eval/eval.h"
+#include "solver/utils/utils.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <span>
+#include <vector>
+
+// Compares the batch GetBestHands against calling EvaluateHand/GetBestHand once per hand.
+
+// Run f, returning the number of millions of hands per second.
+template<typename F>
+double Throughput(const size_t num_hands, F &&f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(num_hands) / elapsed.count() / 1e6;
+}
+
+int main() {
+    constexpr size_t num_hands = 1 << 22;
+    constexpr Eval eval;
+    std::vector<u32> deck = Utils::MakeDeck();
+    std::mt19937 rng(47544);
+
+    for (int cards_per_hand = 5; cards_per_hand <= 7; ++cards_per_hand) {
+        std::vector<u32> cards;
+        cards.reserve(num_hands * cards_per_hand);
+        for (size_t i = 0; i < num_hands; ++i) {
+            std::ranges::shuffle(deck, rng);
+            cards.insert(cards.end(), deck.begin(), deck.begin() + cards_per_hand);
+        }
+
+        std::vector<u16> ranks(num_hands);
+        const double scalar = Throughput(num_hands, [&] {
+            for (size_t i = 0; i < num_hands; ++i) {
+                const auto hand = std::span(cards).subspan(i * cards_per_hand, cards_per_hand);
+                ranks[i] = cards_per_hand == 5 ? eval.EvaluateHand(hand) : eval.GetBestHand(hand);
+            }
+        });
+        long long checksum = 0;
+        for (const u16 rank: ranks) checksum += rank;
+
+        const double batch = Throughput(num_hands, [&] {
+            eval.GetBestHands(cards, cards_per_hand, ranks);
+        });
+        for (const u16 rank: ranks) checksum -= rank;
+
+        std::cout << cards_per_hand << " cards: "
+                  << (cards_per_hand == 5 ? "EvaluateHand " : "GetBestHand  ") << scalar
+                  << " M hands/s, GetBestHands " << batch << " M hands/s ("
+                  << batch / scalar << "x)" << (checksum ? " MISMATCH" : "") << std::endl;
+    }
+
+    return 0;
+}
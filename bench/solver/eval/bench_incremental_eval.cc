@@ -0,0 +1,70 @@
+#include "solver/eval/eval.h"
+#include "solver/eval/incremental_eval.h"
+#include "solver/utils/utils.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// Enumerates every 5-card board for a pair of hole cards, evaluating each 7-card hand from
+// scratch with GetBestHand and then card by card with IncrementalEval.
+
+// Run f, returning the number of millions of hands per second.
+template<typename F>
+double Throughput(const size_t num_hands, F &&f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(num_hands) / elapsed.count() / 1e6;
+}
+
+int main() {
+    constexpr Eval eval;
+    const IncrementalEval incremental_eval;
+    const std::vector<u32> hole = Utils::ParseCards("AsKd");
+
+    std::vector<u32> deck;
+    for (const u32 card: Utils::MakeDeck())
+        if (card != hole[0] && card != hole[1])
+            deck.push_back(card);
+    const int n = static_cast<int>(deck.size());
+    const size_t num_boards = 2118760; // 50 choose 5
+
+    long long scratch_sum = 0;
+    const double scratch = Throughput(num_boards, [&] {
+        for (int a = 0; a < n; ++a)
+            for (int b = a + 1; b < n; ++b)
+                for (int c = b + 1; c < n; ++c)
+                    for (int d = c + 1; d < n; ++d)
+                        for (int e = d + 1; e < n; ++e)
+                            scratch_sum += eval.GetBestHand(std::array{
+                                hole[0], hole[1], deck[a], deck[b], deck[c], deck[d], deck[e]
+                            });
+    });
+
+    long long incremental_sum = 0;
+    const double incremental = Throughput(num_boards, [&] {
+        IncrementalEval::State s0;
+        s0 = incremental_eval.Add(incremental_eval.Add(s0, hole[0]), hole[1]);
+        for (int a = 0; a < n; ++a) {
+            const auto s1 = incremental_eval.Add(s0, deck[a]);
+            for (int b = a + 1; b < n; ++b) {
+                const auto s2 = incremental_eval.Add(s1, deck[b]);
+                for (int c = b + 1; c < n; ++c) {
+                    const auto s3 = incremental_eval.Add(s2, deck[c]);
+                    for (int d = c + 1; d < n; ++d) {
+                        const auto s4 = incremental_eval.Add(s3, deck[d]);
+                        for (int e = d + 1; e < n; ++e)
+                            incremental_sum +=
+                                incremental_eval.GetRank(incremental_eval.Add(s4, deck[e]));
+                    }
+                }
+            }
+        }
+    });
+
+    std::cout << "GetBestHand " << scratch << " M boards/s, IncrementalEval " << incremental
+              << " M boards/s (" << incremental / scratch << "x)"
+              << (scratch_sum != incremental_sum ? " MISMATCH" : "") << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include "solver/preflop/preflop_solver.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Trains the same 100bb tree with each storage precision and prints the memory its regrets and
+// strategy sums take, the exploitability reached, and the time taken, next to the double path.
+// Pass the number of iterations as the first argument (default: 200).
+
+int main(const int argc, char **argv) {
+    const int num_iterations = argc > 1 ? std::stoi(argv[1]) : 200;
+
+    const std::vector<std::shared_ptr<PreflopAction> > actions = {
+        PreflopAction::Fold(), PreflopAction::Check(), PreflopAction::Call(),
+        PreflopAction::Raise(2.5), PreflopAction::Raise(3), PreflopAction::AllIn()
+    };
+    const std::vector<std::pair<std::string, InfosetStore::Precision> > precisions = {
+        {"double", InfosetStore::Precision::DOUBLE}, {"float", InfosetStore::Precision::FLOAT},
+        {"fixed32", InfosetStore::Precision::FIXED32}, {"fixed16", InfosetStore::Precision::FIXED16}
+    };
+
+    size_t base_memory = 0;
+    double base_exploitability = 0;
+    for (const auto &[name, precision]: precisions) {
+        PreflopSolver solver(100, 100, 0, 1, 4, 0.9, actions, actions, {.precision = precision});
+        solver.train(1); // warm up outside the timing
+
+        const auto start = std::chrono::steady_clock::now();
+        solver.train(num_iterations - 1);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        const size_t memory = solver.get_memory_usage();
+        const double exploitability = solver.get_exploitability();
+        if (precision == InfosetStore::Precision::DOUBLE) {
+            base_memory = memory;
+            base_exploitability = exploitability;
+        }
+        std::cout << name << ": " << memory << " bytes (" << 100.0 * memory / base_memory
+                  << "%), exploitability " << exploitability << " bb/hand ("
+                  << exploitability - base_exploitability << " lost), "
+                  << (num_iterations - 1) / elapsed.count() << " iterations/s" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include "solver/preflop/preflop_solver.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Times preflop CFR iterations on a 100bb tree with thread counts 1, 2, 4, ... up to the number of
+// hardware threads, and prints iterations per second and the speedup over one thread. Pass the
+// number of iterations as the first argument (default: 200).
+
+int main(const int argc, char **argv) {
+    const int num_iterations = argc > 1 ? std::stoi(argv[1]) : 200;
+    const int max_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    const std::vector<std::shared_ptr<PreflopAction> > actions = {
+        PreflopAction::Fold(), PreflopAction::Check(), PreflopAction::Call(),
+        PreflopAction::Raise(2.5), PreflopAction::Raise(3), PreflopAction::AllIn()
+    };
+
+    double base_rate = 0;
+    for (int num_threads = 1;; num_threads = std::min(2 * num_threads, max_threads)) {
+        PreflopSolver solver(100, 100, 0, 1, 4, 0.9, actions, actions,
+                             {.num_threads = num_threads});
+        solver.train(1); // warm up outside the timing
+
+        const auto start = std::chrono::steady_clock::now();
+        solver.train(num_iterations);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        const double rate = num_iterations / elapsed.count();
+        if (num_threads == 1)
+            base_rate = rate;
+        std::cout << num_threads << " threads: " << rate << " iterations/s, speedup "
+                  << rate / base_rate << std::endl;
+
+        if (num_threads == max_threads)
+            break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,451 @@
+#include "solver/equity/equity.h"
+#include "solver/eval/board_eval.h"
+#include "solver/eval/incremental_eval.h"
+#include "solver/utils/dealer.h"
+#include "solver/utils/rng.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+double EquityResult::GetEquity() const {
+    const double total = win + tie + lose;
+    return total > 0 ? (win + tie / 2) / total : 0;
+}
+
+EquityResult& EquityResult::operator+=(const EquityResult& other) {
+    win += other.win;
+    tie += other.tie;
+    lose += other.lose;
+    return *this;
+}
+
+// A share of the boards: the first num_dealt of the cards still to come, chosen from the deck
+// (their mask), with the rest to be chosen from deck positions next onwards.
+struct BoardTask {
+    int num_dealt;
+    size_t next;
+    u64 mask;
+};
+
+// Split the ways of dealing num_cards cards from deck into tasks, one per choice of the first
+// (up to) two cards, which is enough to keep every thread busy.
+static std::vector<BoardTask> SplitBoards(const std::vector<int>& deck, const int num_cards) {
+    std::vector<BoardTask> tasks = {{0, 0, 0}};
+    for (int depth = 0; depth < std::min(num_cards, 2); ++depth) {
+        std::vector<BoardTask> next_tasks;
+        for (const BoardTask& task: tasks)
+            for (size_t k = task.next; k + (num_cards - task.num_dealt) <= deck.size(); ++k)
+                next_tasks.push_back({task.num_dealt + 1, k + 1, task.mask | 1ULL << deck[k]});
+        tasks = std::move(next_tasks);
+    }
+    return tasks;
+}
+
+// The indices of the cards not in used, in increasing order.
+static std::vector<int> RemainingDeck(const u64 used) {
+    std::vector<int> deck;
+    for (int i = 0; i < Utils::NUM_CARDS; ++i)
+        if (!(used >> i & 1))
+            deck.push_back(i);
+    return deck;
+}
+
+// Check that cards has no duplicates and none in used, and return used with cards added.
+static u64 AddCards(const u64 used, const std::span<const u32> cards) {
+    const u64 mask = Utils::CardsToMask(cards);
+    if (std::popcount(mask) != static_cast<int>(cards.size()) || (mask & used))
+        throw std::invalid_argument("the same card was given twice");
+    return used | mask;
+}
+
+// Record one showdown between two complete hands.
+static void AddShowdown(const int rank1, const int rank2, EquityResult& result) {
+    result.win += rank1 < rank2;
+    result.tie += rank1 == rank2;
+    result.lose += rank1 > rank2;
+}
+
+// Deal cards_left more cards from deck positions start onwards to both hands, and count every
+// showdown into result.
+static void DealHands(const IncrementalEval& eval, const std::vector<int>& deck,
+                      const size_t start, const int cards_left, const IncrementalEval::State hand1,
+                      const IncrementalEval::State hand2, EquityResult& result) {
+    if (!cards_left) {
+        AddShowdown(eval.GetRank(hand1), eval.GetRank(hand2), result);
+        return;
+    }
+
+    for (size_t k = start; k + cards_left <= deck.size(); ++k) {
+        const u32 card = Utils::IndexToCard(deck[k]);
+        DealHands(eval, deck, k + 1, cards_left - 1, eval.Add(hand1, card), eval.Add(hand2, card),
+                  result);
+    }
+}
+
+// Call f(board) for every board made by adding cards_left cards from deck positions start
+// onwards to the board mask.
+template<typename F>
+static void ForEachBoard(const std::vector<int>& deck, const size_t start, const int cards_left,
+                         const u64 board, F&& f) {
+    if (!cards_left) {
+        f(board);
+        return;
+    }
+    for (size_t k = start; k + cards_left <= deck.size(); ++k)
+        ForEachBoard(deck, k + 1, cards_left - 1, board | 1ULL << deck[k], f);
+}
+
+// Sample showdowns with sample(rng, dealer, result) until options says to stop. Samples come in
+// batches of BATCH_SIZE, each drawing from its own stream of the seed; ROUND_SIZE batches run at
+// a time, one per task, and the stopping rule is checked between rounds. Batches are added up in
+// order, so the result depends only on the seed.
+template<typename F>
+static MonteCarloResult RunMonteCarlo(TaskScheduler& scheduler, const MonteCarloOptions& options,
+                                      const Dealer& dealer, F&& sample) {
+    constexpr u64 BATCH_SIZE = 4096;
+    constexpr size_t ROUND_SIZE = 64;
+
+    Rng seeds(options.seed);
+    MonteCarloResult estimate;
+    for (u64 num_samples = 0; num_samples < options.max_samples;) {
+        const u64 batches_left = (options.max_samples - num_samples + BATCH_SIZE - 1) / BATCH_SIZE;
+        const size_t num_batches = std::min<u64>(ROUND_SIZE, batches_left);
+        std::vector<Rng> streams;
+        for (size_t b = 0; b < num_batches; ++b)
+            streams.push_back(seeds.Split());
+
+        std::vector<EquityResult> batches(num_batches);
+        scheduler.ParallelFor(num_batches, [&](const size_t b, int) {
+            Dealer batch_dealer = dealer;
+            for (u64 k = 0; k < BATCH_SIZE; ++k)
+                sample(streams[b], batch_dealer, batches[b]);
+        });
+        for (const EquityResult& batch: batches)
+            estimate.result += batch;
+        num_samples += num_batches * BATCH_SIZE;
+
+        // each showdown scores 1, 1/2 or 0
+        const double n = static_cast<double>(num_samples);
+        const double mean = estimate.result.GetEquity();
+        const double mean_square = (estimate.result.win + estimate.result.tie / 4) / n;
+        estimate.error = options.z * std::sqrt(std::max(0.0, mean_square - mean * mean) / n);
+        if (num_samples >= options.min_samples && estimate.error <= options.target_error)
+            break;
+    }
+    return estimate;
+}
+
+EquityCalculator::EquityCalculator(const int num_threads) : scheduler(num_threads) {
+}
+
+EquityResult EquityCalculator::HandVsHand(const std::span<const u32> hand1,
+                                          const std::span<const u32> hand2,
+                                          const std::span<const u32> board,
+                                          const std::span<const u32> dead) const {
+    if (hand1.size() != 2 || hand2.size() != 2)
+        throw std::invalid_argument("hands must have 2 cards");
+    if (board.size() > 5)
+        throw std::invalid_argument("board can't have more than 5 cards");
+    const u64 used = AddCards(AddCards(AddCards(AddCards(0, hand1), hand2), board), dead);
+    const int cards_left = 5 - static_cast<int>(board.size());
+    const std::vector<int> deck = RemainingDeck(used);
+    if (static_cast<int>(deck.size()) < cards_left)
+        throw std::invalid_argument("not enough cards left to deal the board");
+
+    const IncrementalEval eval;
+    IncrementalEval::State state1, state2;
+    for (const u32 card: board) {
+        state1 = eval.Add(state1, card);
+        state2 = eval.Add(state2, card);
+    }
+    for (int i = 0; i < 2; ++i) {
+        state1 = eval.Add(state1, hand1[i]);
+        state2 = eval.Add(state2, hand2[i]);
+    }
+
+    // one accumulator per thread, each on its own cache line
+    struct alignas(64) Accumulator {
+        EquityResult result;
+    };
+    std::vector<Accumulator> accumulators(scheduler.GetNumThreads());
+    const std::vector<BoardTask> tasks = SplitBoards(deck, cards_left);
+
+    scheduler.ParallelFor(tasks.size(), [&](const size_t t, const int thread) {
+        IncrementalEval::State task1 = state1, task2 = state2;
+        for (u64 mask = tasks[t].mask; mask; mask &= mask - 1) {
+            const u32 card = Utils::IndexToCard(std::countr_zero(mask));
+            task1 = eval.Add(task1, card);
+            task2 = eval.Add(task2, card);
+        }
+        DealHands(eval, deck, tasks[t].next, cards_left - tasks[t].num_dealt, task1, task2,
+                  accumulators[thread].result);
+    });
+
+    EquityResult result;
+    for (const Accumulator& accumulator: accumulators)
+        result += accumulator.result;
+    return result;
+}
+
+RangeEquity EquityCalculator::RangeVsRange(const std::span<const double> range1,
+                                           const std::span<const double> range2,
+                                           const std::span<const u32> board,
+                                           const std::span<const u32> dead) const {
+    if (range1.size() != Utils::NUM_COMBOS || range2.size() != Utils::NUM_COMBOS)
+        throw std::invalid_argument("ranges must have a weight for every combo");
+    if (board.size() > 5)
+        throw std::invalid_argument("board can't have more than 5 cards");
+    const u64 known = AddCards(AddCards(0, board), dead);
+    const u64 board_mask = Utils::CardsToMask(board);
+    const int cards_left = 5 - static_cast<int>(board.size());
+    const std::vector<int> deck = RemainingDeck(known);
+
+    // drop the combos that hold a dead or board card
+    std::vector<std::pair<int, int> > combo_cards(Utils::NUM_COMBOS);
+    std::vector<double> weights1(range1.begin(), range1.end());
+    std::vector<double> weights2(range2.begin(), range2.end());
+    for (int combo = 0; combo < Utils::NUM_COMBOS; ++combo) {
+        combo_cards[combo] = Utils::ComboToIndices(combo);
+        auto [i, j] = combo_cards[combo];
+        if ((known >> i | known >> j) & 1)
+            weights1[combo] = weights2[combo] = 0;
+    }
+
+    std::vector<std::vector<EquityResult> > accumulators(
+        scheduler.GetNumThreads(), std::vector<EquityResult>(Utils::NUM_COMBOS));
+    const std::vector<BoardTask> tasks = SplitBoards(deck, cards_left);
+
+    // a combo on one board, as the showdown sweep reads it
+    struct Entry {
+        int rank, i, j;
+        double weight1, weight2, beaten; // beaten: range 2's weight that beats this combo
+        u16 combo;
+    };
+
+    scheduler.ParallelFor(tasks.size(), [&](const size_t t, const int thread) {
+        std::vector<EquityResult>& combos = accumulators[thread];
+        std::vector<Entry> entries;
+        entries.reserve(Utils::NUM_COMBOS);
+
+        ForEachBoard(deck, tasks[t].next, cards_left - tasks[t].num_dealt,
+                     board_mask | tasks[t].mask, [&](const u64 full_board) {
+            const BoardEval board_eval(full_board);
+
+            // Sweep the combos from strongest to weakest, one group of equal rank at a time,
+            // keeping range 2's weight so far in total and per card. A combo's opponents are
+            // range 2 minus the combos sharing one of its cards; by inclusion-exclusion that is
+            // all - all[i] - all[j] + its own weight (counted in both cards).
+            double all = 0;
+            std::array<double, Utils::NUM_CARDS> all_card{};
+            entries.clear();
+            for (const u16 combo: board_eval.GetSortedCombos()) {
+                const double w1 = weights1[combo], w2 = weights2[combo];
+                if (!w1 && !w2) continue;
+                auto [i, j] = combo_cards[combo];
+                entries.push_back({board_eval.GetRank(combo), i, j, w1, w2, 0, combo});
+                all += w2;
+                all_card[i] += w2;
+                all_card[j] += w2;
+            }
+
+            double not_weaker = 0;
+            std::array<double, Utils::NUM_CARDS> not_weaker_card{};
+            for (size_t begin = 0, end; begin < entries.size(); begin = end) {
+                // before the group is added, not_weaker counts the stronger combos only
+                for (end = begin; end < entries.size() && entries[end].rank == entries[begin].rank;
+                     ++end) {
+                    Entry& e = entries[end];
+                    e.beaten = not_weaker - not_weaker_card[e.i] - not_weaker_card[e.j];
+                }
+                for (size_t k = begin; k < end; ++k) {
+                    const Entry& e = entries[k];
+                    not_weaker += e.weight2;
+                    not_weaker_card[e.i] += e.weight2;
+                    not_weaker_card[e.j] += e.weight2;
+                }
+
+                for (size_t k = begin; k < end; ++k) {
+                    const Entry& e = entries[k];
+                    if (!e.weight1) continue;
+                    const double opponents = all - all_card[e.i] - all_card[e.j] + e.weight2;
+                    const double at_least = not_weaker - not_weaker_card[e.i] -
+                                            not_weaker_card[e.j] + e.weight2;
+                    combos[e.combo].win += e.weight1 * (opponents - at_least);
+                    combos[e.combo].tie += e.weight1 * (at_least - e.beaten);
+                    combos[e.combo].lose += e.weight1 * e.beaten;
+                }
+            }
+        });
+    });
+
+    RangeEquity result;
+    result.combos.assign(Utils::NUM_COMBOS, {});
+    for (const std::vector<EquityResult>& combos: accumulators)
+        for (int combo = 0; combo < Utils::NUM_COMBOS; ++combo)
+            result.combos[combo] += combos[combo];
+    for (const EquityResult& combo: result.combos)
+        result.total += combo;
+    return result;
+}
+
+MonteCarloResult EquityCalculator::EstimateHandVsHand(const std::span<const u32> hand1,
+                                                      const std::span<const u32> hand2,
+                                                      const std::span<const u32> board,
+                                                      const std::span<const u32> dead,
+                                                      const MonteCarloOptions& options) const {
+    if (hand1.size() != 2 || hand2.size() != 2)
+        throw std::invalid_argument("hands must have 2 cards");
+    if (board.size() > 5)
+        throw std::invalid_argument("board can't have more than 5 cards");
+    const u64 used = AddCards(AddCards(AddCards(AddCards(0, hand1), hand2), board), dead);
+    const int cards_left = 5 - static_cast<int>(board.size());
+    const Dealer dealer(used);
+    if (dealer.GetSize() < cards_left)
+        throw std::invalid_argument("not enough cards left to deal the board");
+
+    const IncrementalEval eval;
+    IncrementalEval::State state1, state2;
+    for (const u32 card: board) {
+        state1 = eval.Add(state1, card);
+        state2 = eval.Add(state2, card);
+    }
+    for (int i = 0; i < 2; ++i) {
+        state1 = eval.Add(state1, hand1[i]);
+        state2 = eval.Add(state2, hand2[i]);
+    }
+
+    return RunMonteCarlo(
+        scheduler, options, dealer, [&](Rng& rng, Dealer& d, EquityResult& result) {
+            std::array<u32, 5> cards{};
+            d.Deal(rng, std::span(cards).first(cards_left));
+            IncrementalEval::State s1 = state1, s2 = state2;
+            for (int k = 0; k < cards_left; ++k) {
+                s1 = eval.Add(s1, cards[k]);
+                s2 = eval.Add(s2, cards[k]);
+            }
+            AddShowdown(eval.GetRank(s1), eval.GetRank(s2), result);
+        });
+}
+
+MonteCarloResult EquityCalculator::EstimateRangeVsRange(const std::span<const double> range1,
+                                                        const std::span<const double> range2,
+                                                        const std::span<const u32> board,
+                                                        const std::span<const u32> dead,
+                                                        const MonteCarloOptions& options) const {
+    if (range1.size() != Utils::NUM_COMBOS || range2.size() != Utils::NUM_COMBOS)
+        throw std::invalid_argument("ranges must have a weight for every combo");
+    if (board.size() > 5)
+        throw std::invalid_argument("board can't have more than 5 cards");
+    const u64 known = AddCards(AddCards(0, board), dead);
+    const int cards_left = 5 - static_cast<int>(board.size());
+
+    // running totals of the weights of the live combos, to sample from by binary search; and
+    // range 2's weight per card, to check some pair of combos can meet
+    std::vector<double> cumulative1(Utils::NUM_COMBOS), cumulative2(Utils::NUM_COMBOS);
+    std::vector<u64> combo_masks(Utils::NUM_COMBOS);
+    std::array<double, Utils::NUM_CARDS> card_weights2{};
+    double total1 = 0, total2 = 0;
+    for (int combo = 0; combo < Utils::NUM_COMBOS; ++combo) {
+        auto [i, j] = Utils::ComboToIndices(combo);
+        combo_masks[combo] = 1ULL << i | 1ULL << j;
+        if (!(combo_masks[combo] & known)) {
+            total1 += range1[combo];
+            total2 += range2[combo];
+            card_weights2[i] += range2[combo];
+            card_weights2[j] += range2[combo];
+        }
+        cumulative1[combo] = total1;
+        cumulative2[combo] = total2;
+    }
+    double matchups = 0;
+    for (int combo = 0; combo < Utils::NUM_COMBOS; ++combo) {
+        auto [i, j] = Utils::ComboToIndices(combo);
+        if (!(combo_masks[combo] & known))
+            matchups += range1[combo] *
+                        (total2 - card_weights2[i] - card_weights2[j] + range2[combo]);
+    }
+    if (!(matchups > 0))
+        throw std::invalid_argument("no pair of combos from the two ranges can meet");
+
+    const Dealer dealer(known);
+    const IncrementalEval eval;
+    IncrementalEval::State board_state;
+    for (const u32 card: board)
+        board_state = eval.Add(board_state, card);
+
+    auto sample_combo = [](Rng& rng, const std::vector<double>& cumulative, const double total) {
+        const auto it = std::ranges::upper_bound(cumulative, rng.NextDouble() * total);
+        return static_cast<int>(std::min<ptrdiff_t>(it - cumulative.begin(),
+                                                    Utils::NUM_COMBOS - 1));
+    };
+
+    return RunMonteCarlo(
+        scheduler, options, dealer, [&](Rng& rng, Dealer& d, EquityResult& result) {
+            int combo1, combo2;
+            do {
+                combo1 = sample_combo(rng, cumulative1, total1);
+                combo2 = sample_combo(rng, cumulative2, total2);
+            } while (combo_masks[combo1] & combo_masks[combo2]);
+
+            IncrementalEval::State s1 = board_state, s2 = board_state;
+            for (u64 mask = combo_masks[combo1]; mask; mask &= mask - 1)
+                s1 = eval.Add(s1, Utils::IndexToCard(std::countr_zero(mask)));
+            for (u64 mask = combo_masks[combo2]; mask; mask &= mask - 1)
+                s2 = eval.Add(s2, Utils::IndexToCard(std::countr_zero(mask)));
+
+            std::array<u32, 5> cards{};
+            d.Deal(rng, std::span(cards).first(cards_left),
+                   combo_masks[combo1] | combo_masks[combo2]);
+            for (int k = 0; k < cards_left; ++k) {
+                s1 = eval.Add(s1, cards[k]);
+                s2 = eval.Add(s2, cards[k]);
+            }
+            AddShowdown(eval.GetRank(s1), eval.GetRank(s2), result);
+        });
+}
+
+std::vector<double> EquityCalculator::ParseRange(const std::string& range) {
+    static const std::string ranks = "23456789TJQKA";
+    std::vector<double> weights(Utils::NUM_COMBOS);
+
+    std::stringstream entries(range);
+    for (std::string entry; std::getline(entries, entry, ',');) {
+        entry.erase(std::remove(entry.begin(), entry.end(), ' '), entry.end());
+        if (entry.empty()) continue;
+
+        double weight = 1;
+        if (const size_t colon = entry.find(':'); colon != std::string::npos) {
+            weight = std::stod(entry.substr(colon + 1));
+            entry.resize(colon);
+        }
+
+        if (entry.size() == 4) {
+            const std::vector<u32> cards = Utils::ParseCards(entry);
+            const int i = Utils::CardToIndex(cards[0]), j = Utils::CardToIndex(cards[1]);
+            if (i == j)
+                throw std::invalid_argument("invalid combo: " + entry);
+            weights[Utils::ComboIndex(i, j)] = weight;
+            continue;
+        }
+
+        const size_t r1 = entry.size() >= 2 ? ranks.find(entry[0]) : std::string::npos;
+        const size_t r2 = entry.size() >= 2 ? ranks.find(entry[1]) : std::string::npos;
+        const char kind = entry.size() == 3 ? entry[2] : ' ';
+        if (r1 == std::string::npos || r2 == std::string::npos || entry.size() > 3 ||
+            (kind != ' ' && kind != 's' && kind != 'o') || (r1 == r2 && kind != ' '))
+            throw std::invalid_argument("invalid hand: " + entry);
+
+        for (int s1 = 0; s1 < 4; ++s1)
+            for (int s2 = 0; s2 < 4; ++s2) {
+                const int i = 4 * static_cast<int>(r1) + s1, j = 4 * static_cast<int>(r2) + s2;
+                if (i == j || (kind == 's' && s1 != s2) || (kind == 'o' && s1 == s2) ||
+                    (r1 == r2 && s1 > s2))
+                    continue;
+                weights[Utils::ComboIndex(i, j)] = weight;
+            }
+    }
+
+    return weights;
+}
@@ -0,0 +1,138 @@
+#ifndef EQUITY_H
+#define EQUITY_H
+
+#include "solver/eval/eval.h"
+#include "solver/utils/task_scheduler.h"
+#include "solver/utils/utils.h"
+#include <span>
+#include <string>
+#include <vector>
+
+// How often one side of a matchup wins, ties and loses at showdown. Each board counts with the
+// weight of the matchup (1 for hand vs hand), so results can be added up across boards, combos
+// and threads.
+struct EquityResult {
+    double win = 0, tie = 0, lose = 0;
+
+    /**
+     * Returns the share of the pot won, counting a tie as half.
+     * @return the equity in [0, 1], or 0 if nothing was counted
+     */
+    [[nodiscard]] double GetEquity() const;
+
+    EquityResult& operator+=(const EquityResult& other);
+};
+
+// Result of EquityCalculator::RangeVsRange.
+struct RangeEquity {
+    // the first range against the second, over every combo and board
+    EquityResult total;
+    // each combo of the first range against the second, indexed by Utils::ComboIndex; all zero
+    // for combos with no weight
+    std::vector<EquityResult> combos;
+};
+
+// Settings for EquityCalculator's Monte Carlo estimates.
+struct MonteCarloOptions {
+    // equal seeds give equal results, whatever the number of threads
+    u64 seed = 0;
+    // stop once the confidence interval's half-width is at most this...
+    double target_error = 1e-3;
+    // ...where the interval is the estimate +- z standard errors (1.96 for 95%)
+    double z = 1.96;
+    // bounds on the number of showdowns sampled; both are rounded up to a whole batch
+    u64 min_samples = 10000;
+    u64 max_samples = 100000000;
+};
+
+// Result of a Monte Carlo estimate.
+struct MonteCarloResult {
+    // the sampled showdowns
+    EquityResult result;
+    // half-width of the confidence interval around result.GetEquity()
+    double error = 0;
+};
+
+// Computes exact all-in equities by enumerating every board. The boards are split across a
+// TaskScheduler; each thread adds into its own accumulator, and the accumulators are summed at the
+// end. Combos that share a card with the board, the dead cards or each other are removed with
+// 52-bit card masks.
+class EquityCalculator {
+    mutable TaskScheduler scheduler;
+
+public:
+    /**
+     * Constructor for EquityCalculator.
+     * @param num_threads threads to enumerate boards on; 0 means one per hardware thread
+     */
+    explicit EquityCalculator(int num_threads = 0);
+
+    /**
+     * Returns the equity of one hand against another.
+     * @param hand1 the first hand's 2 cards
+     * @param hand2 the second hand's 2 cards
+     * @param board 0 to 5 cards already dealt; the rest of the board is enumerated
+     * @param dead cards that can't be dealt
+     * @return the first hand's result, counting each board once
+     */
+    [[nodiscard]] EquityResult HandVsHand(std::span<const u32> hand1, std::span<const u32> hand2,
+                                          std::span<const u32> board = {},
+                                          std::span<const u32> dead = {}) const;
+
+    /**
+     * Returns the equity of one weighted range against another. A range holds a weight for
+     * every combo, indexed by Utils::ComboIndex (see ParseRange). Each board counts for each pair
+     * of combos with the product of their weights.
+     * @param range1 the first range's weights, NUM_COMBOS of them
+     * @param range2 the second range's weights, NUM_COMBOS of them
+     * @param board 0 to 5 cards already dealt; the rest of the board is enumerated
+     * @param dead cards that can't be dealt or held
+     * @return the first range's results, in total and per combo
+     */
+    [[nodiscard]] RangeEquity RangeVsRange(std::span<const double> range1,
+                                           std::span<const double> range2,
+                                           std::span<const u32> board = {},
+                                           std::span<const u32> dead = {}) const;
+
+    /**
+     * Estimates the equity of one hand against another by sampling boards, stopping early once
+     * the estimate is within options.target_error.
+     * @param hand1 the first hand's 2 cards
+     * @param hand2 the second hand's 2 cards
+     * @param board 0 to 5 cards already dealt
+     * @param dead cards that can't be dealt
+     * @param options the seed and stopping rule
+     * @return the first hand's sampled results and the estimate's error
+     */
+    [[nodiscard]] MonteCarloResult EstimateHandVsHand(std::span<const u32> hand1,
+                                                      std::span<const u32> hand2,
+                                                      std::span<const u32> board = {},
+                                                      std::span<const u32> dead = {},
+                                                      const MonteCarloOptions& options = {}) const;
+
+    /**
+     * Estimates the equity of one weighted range against another by sampling a combo from each
+     * range (by weight, redrawing pairs that share a card) and then a board.
+     * @param range1 the first range's weights, NUM_COMBOS of them
+     * @param range2 the second range's weights, NUM_COMBOS of them
+     * @param board 0 to 5 cards already dealt
+     * @param dead cards that can't be dealt or held
+     * @param options the seed and stopping rule
+     * @return the first range's sampled results and the estimate's error
+     */
+    [[nodiscard]] MonteCarloResult EstimateRangeVsRange(
+        std::span<const double> range1, std::span<const double> range2,
+        std::span<const u32> board = {}, std::span<const u32> dead = {},
+        const MonteCarloOptions& options = {}) const;
+
+    /**
+     * Build a range from a comma-separated list of hands, e.g. "AA,AKs,KQo,T9,AhKh,JJ:0.5". A
+     * pair, suited (s) or offsuit (o) hand class adds all its combos, a class with no s/o adds
+     * both, and 4 characters name one combo. ":w" gives the entries a weight of w instead of 1.
+     * @param range the range string
+     * @return the weight of every combo, indexed by Utils::ComboIndex
+     */
+    static std::vector<double> ParseRange(const std::string& range);
+};
+
+#endif //EQUITY_H
@@ -0,0 +1,148 @@
+#include "solver/equity/preflop_equity.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+PreflopEquityTable::PreflopEquityTable(std::vector<float> class_equities,
+                                       std::vector<float> combo_equities) {
+    constexpr size_t num_classes = Utils::NUM_HAND_CLASSES * Utils::NUM_HAND_CLASSES;
+    constexpr size_t num_combos = Utils::NUM_COMBOS * Utils::NUM_COMBOS;
+    if (class_equities.size() != num_classes)
+        throw std::invalid_argument("class table must have 169 * 169 entries");
+    if (!combo_equities.empty() && combo_equities.size() != num_combos)
+        throw std::invalid_argument("combo table must be empty or have 1326 * 1326 entries");
+
+    storage = std::move(class_equities);
+    storage.insert(storage.end(), combo_equities.begin(), combo_equities.end());
+    this->class_equities = std::span(storage).first(num_classes);
+    this->combo_equities = std::span(storage).subspan(num_classes);
+}
+
+PreflopEquityTable::PreflopEquityTable(MappedFile file, const std::span<const float> class_equities,
+                                       const std::span<const float> combo_equities)
+    : file(std::move(file)), class_equities(class_equities), combo_equities(combo_equities) {
+}
+
+PreflopEquityTable PreflopEquityTable::Compute(
+    const EquityCalculator& calculator, const bool with_combos,
+    const std::function<void(size_t, size_t)>& progress) {
+    auto share_a_card = [](const int combo1, const int combo2) {
+        auto [a, b] = Utils::ComboToIndices(combo1);
+        auto [c, d] = Utils::ComboToIndices(combo2);
+        return a == c || a == d || b == c || b == d;
+    };
+
+    // every matchup that shares no card, by its canonical key
+    std::unordered_map<u32, float> equities;
+    for (int combo1 = 0; combo1 < Utils::NUM_COMBOS; ++combo1)
+        for (int combo2 = 0; combo2 < combo1; ++combo2)
+            if (!share_a_card(combo1, combo2))
+                equities.emplace(CanonicalMatchup(combo1, combo2), 0.0f);
+
+    // the matchups are spread over the threads inside HandVsHand
+    size_t done = 0;
+    for (auto& [key, equity]: equities) {
+        auto [a, b] = Utils::ComboToIndices(static_cast<int>(key / Utils::NUM_COMBOS));
+        auto [c, d] = Utils::ComboToIndices(static_cast<int>(key % Utils::NUM_COMBOS));
+        const std::array hand1 = {Utils::IndexToCard(a), Utils::IndexToCard(b)};
+        const std::array hand2 = {Utils::IndexToCard(c), Utils::IndexToCard(d)};
+        equity = static_cast<float>(calculator.HandVsHand(hand1, hand2).GetEquity());
+        if (progress)
+            progress(++done, equities.size());
+    }
+
+    std::vector<float> combos(Utils::NUM_COMBOS * Utils::NUM_COMBOS,
+                              std::numeric_limits<float>::quiet_NaN());
+    std::vector<double> class_sums(Utils::NUM_HAND_CLASSES * Utils::NUM_HAND_CLASSES);
+    std::vector<int> class_counts(Utils::NUM_HAND_CLASSES * Utils::NUM_HAND_CLASSES);
+    for (int combo1 = 0; combo1 < Utils::NUM_COMBOS; ++combo1)
+        for (int combo2 = 0; combo2 < combo1; ++combo2) {
+            if (share_a_card(combo1, combo2)) continue;
+
+            const float equity = equities.at(CanonicalMatchup(combo1, combo2));
+            combos[combo1 * Utils::NUM_COMBOS + combo2] = equity;
+            combos[combo2 * Utils::NUM_COMBOS + combo1] = 1 - equity;
+
+            const int class1 = Utils::ComboToHandClass(combo1);
+            const int class2 = Utils::ComboToHandClass(combo2);
+            class_sums[class1 * Utils::NUM_HAND_CLASSES + class2] += equity;
+            class_sums[class2 * Utils::NUM_HAND_CLASSES + class1] += 1 - equity;
+            ++class_counts[class1 * Utils::NUM_HAND_CLASSES + class2];
+            ++class_counts[class2 * Utils::NUM_HAND_CLASSES + class1];
+        }
+
+    std::vector<float> classes(Utils::NUM_HAND_CLASSES * Utils::NUM_HAND_CLASSES);
+    for (size_t k = 0; k < classes.size(); ++k)
+        classes[k] = static_cast<float>(class_sums[k] / class_counts[k]);
+
+    if (!with_combos)
+        combos.clear();
+    return PreflopEquityTable(std::move(classes), std::move(combos));
+}
+
+PreflopEquityTable PreflopEquityTable::Load(const std::string& path) {
+    MappedFile file(path);
+    const std::span<const std::byte> data = file.GetData();
+
+    Header header{};
+    if (data.size() < sizeof(Header))
+        throw std::runtime_error(path + " is not a preflop equity table");
+    std::memcpy(&header, data.data(), sizeof(Header));
+    if (header.magic != MAGIC)
+        throw std::runtime_error(path + " is not a preflop equity table");
+    if (header.version != VERSION)
+        throw std::runtime_error(path + " has version " + std::to_string(header.version) +
+                                 ", expected " + std::to_string(VERSION));
+
+    const size_t num_classes = static_cast<size_t>(header.num_classes) * header.num_classes;
+    const size_t num_combos = static_cast<size_t>(header.num_combos) * header.num_combos;
+    if (header.num_classes != Utils::NUM_HAND_CLASSES ||
+        (header.num_combos != 0 && header.num_combos != Utils::NUM_COMBOS) ||
+        data.size() != sizeof(Header) + (num_classes + num_combos) * sizeof(float))
+        throw std::runtime_error(path + " has the wrong size");
+
+    // the header is 24 bytes, so the floats are aligned within the page-aligned mapping
+    const auto* floats = reinterpret_cast<const float*>(data.data() + sizeof(Header));
+    return PreflopEquityTable(std::move(file), {floats, num_classes},
+                              {floats + num_classes, num_combos});
+}
+
+void PreflopEquityTable::Save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("can't open " + path);
+
+    const Header header = {
+        MAGIC, VERSION, Utils::NUM_HAND_CLASSES,
+        combo_equities.empty() ? 0u : static_cast<u32>(Utils::NUM_COMBOS), 0
+    };
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(class_equities.data()),
+              static_cast<std::streamsize>(class_equities.size_bytes()));
+    out.write(reinterpret_cast<const char*>(combo_equities.data()),
+              static_cast<std::streamsize>(combo_equities.size_bytes()));
+    if (!out)
+        throw std::runtime_error("can't write " + path);
+}
+
+bool PreflopEquityTable::HasComboEquities() const {
+    return !combo_equities.empty();
+}
+
+u32 PreflopEquityTable::CanonicalMatchup(const int combo1, const int combo2) {
+    auto [a, b] = Utils::ComboToIndices(combo1);
+    auto [c, d] = Utils::ComboToIndices(combo2);
+
+    u32 best = std::numeric_limits<u32>::max();
+    std::array<int, 4> suits = {0, 1, 2, 3};
+    do {
+        auto relabel = [&](const int card) { return card - card % 4 + suits[card % 4]; };
+        const u32 key = Utils::ComboIndex(relabel(a), relabel(b)) * Utils::NUM_COMBOS +
+                        Utils::ComboIndex(relabel(c), relabel(d));
+        best = std::min(best, key);
+    } while (std::ranges::next_permutation(suits).found);
+    return best;
+}
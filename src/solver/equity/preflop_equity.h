@@ -0,0 +1,120 @@
+#ifndef PREFLOP_EQUITY_H
+#define PREFLOP_EQUITY_H
+
+#include "solver/equity/equity.h"
+#include "solver/utils/mapped_file.h"
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+// Preflop all-in equities of every hand class against every other (169x169), and optionally of
+// every combo against every other (1326x1326, with card removal). Computing them takes a long
+// enumeration, so they are computed once (see tools/solver/equity/gen_preflop_equity.cc), saved,
+// and loaded with mmap: opening the table is instant and the pages are shared between processes.
+//
+// File format, in native byte order (little-endian on every supported platform):
+//   char  magic[8]       "GTOEQTY\0"
+//   u32   version        VERSION
+//   u32   num_classes    169
+//   u32   num_combos     1326, or 0 if the combo table is left out
+//   u32   reserved       0
+//   float classes[169 * 169]
+//   float combos[num_combos * num_combos]
+class PreflopEquityTable {
+public:
+    static constexpr u32 VERSION = 1;
+
+private:
+    struct Header {
+        std::array<char, 8> magic;
+        u32 version, num_classes, num_combos, reserved;
+    };
+    static constexpr std::array<char, 8> MAGIC = {'G', 'T', 'O', 'E', 'Q', 'T', 'Y', '\0'};
+
+    // where the equities live: a mapped file, or storage for a table built in memory
+    std::optional<MappedFile> file;
+    std::vector<float> storage;
+    std::span<const float> class_equities, combo_equities;
+
+public:
+    /**
+     * Build a table from equities computed elsewhere.
+     * @param class_equities 169 * 169 equities, row class against column class
+     * @param combo_equities 1326 * 1326 equities, row combo against column combo, or empty
+     */
+    explicit PreflopEquityTable(std::vector<float> class_equities,
+                                std::vector<float> combo_equities = {});
+
+    /**
+     * Compute the table by enumerating every board for every matchup, up to suit isomorphism.
+     * @param calculator the calculator to run the matchups on
+     * @param with_combos whether to keep the 1326x1326 combo table too
+     * @param progress if set, called with (matchups done, total matchups) after each matchup
+     * @return the table
+     */
+    static PreflopEquityTable Compute(const EquityCalculator& calculator, bool with_combos,
+                                      const std::function<void(size_t, size_t)>& progress = {});
+
+    /**
+     * Map a table saved by Save. Throws std::runtime_error if the file can't be read or isn't a
+     * table of this version.
+     * @param path the file to load
+     * @return the table, backed by the mapped file
+     */
+    static PreflopEquityTable Load(const std::string& path);
+
+    /**
+     * Write the table to a file, in the format above.
+     * @param path the file to write
+     */
+    void Save(const std::string& path) const;
+
+    /**
+     * Returns the equity of one hand class against another, averaged over the pairs of combos
+     * that don't share a card.
+     * @param class1 hand class index, as in Utils::ComboToHandClass
+     * @param class2 hand class index
+     * @return the equity of class1, counting ties as half
+     */
+    [[nodiscard]] double GetEquity(int class1, int class2) const;
+
+    /**
+     * Returns whether the table holds combo equities.
+     * @return whether GetComboEquity can be called
+     */
+    [[nodiscard]] bool HasComboEquities() const;
+
+    /**
+     * Returns the equity of one combo against another.
+     * @param combo1 combo index, as in Utils::ComboIndex
+     * @param combo2 combo index
+     * @return the equity of combo1, or NaN if the combos share a card
+     */
+    [[nodiscard]] double GetComboEquity(int combo1, int combo2) const;
+
+    /**
+     * Returns the smallest key combo1 * NUM_COMBOS + combo2 over the 24 ways to relabel suits,
+     * so matchups that are the same up to suits share a key.
+     * @param combo1 combo index, as in Utils::ComboIndex
+     * @param combo2 combo index
+     * @return the matchup's canonical key
+     */
+    [[nodiscard]] static u32 CanonicalMatchup(int combo1, int combo2);
+
+private:
+    // A table backed by a mapped file; the spans point into it.
+    PreflopEquityTable(MappedFile file, std::span<const float> class_equities,
+                       std::span<const float> combo_equities);
+};
+
+inline double PreflopEquityTable::GetEquity(const int class1, const int class2) const {
+    return class_equities[class1 * Utils::NUM_HAND_CLASSES + class2];
+}
+
+inline double PreflopEquityTable::GetComboEquity(const int combo1, const int combo2) const {
+    return combo_equities[combo1 * Utils::NUM_COMBOS + combo2];
+}
+
+#endif //PREFLOP_EQUITY_H
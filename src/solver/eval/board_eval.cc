@@ -0,0 +1,69 @@
+#include "solver/eval/board_eval.h"
+#include "solver/eval/incremental_eval.h"
+#include <array>
+#include <bit>
+#include <stdexcept>
+
+BoardEval::BoardEval(const std::span<const u32> board) : BoardEval(Utils::CardsToMask(board)) {
+}
+
+BoardEval::BoardEval(const u64 board_mask) : board_mask(board_mask), ranks{} {
+    if (board_mask >> Utils::NUM_CARDS)
+        throw std::invalid_argument("board mask has bits past the last card");
+    if (std::popcount(board_mask) < 3 || std::popcount(board_mask) > 5)
+        throw std::invalid_argument("board must have 3 to 5 cards");
+
+    const IncrementalEval eval;
+    IncrementalEval::State board;
+    for (int i = 0; i < Utils::NUM_CARDS; ++i)
+        if (board_mask >> i & 1)
+            board = eval.Add(board, Utils::IndexToCard(i));
+
+    // sort keys hold the rank above the combo index, which fits in 11 bits
+    std::vector<u32> keys;
+    keys.reserve(Utils::NUM_COMBOS);
+    for (int i = 0; i < Utils::NUM_CARDS; ++i) {
+        if (board_mask >> i & 1) continue;
+        const IncrementalEval::State board_and_i = eval.Add(board, Utils::IndexToCard(i));
+
+        for (int j = 0; j < i; ++j) {
+            if (board_mask >> j & 1) continue;
+            const int combo = Utils::ComboIndex(i, j);
+            ranks[combo] = eval.GetRank(eval.Add(board_and_i, Utils::IndexToCard(j)));
+            keys.push_back(static_cast<u32>(ranks[combo]) << 11 | combo);
+        }
+    }
+
+    // ranks are below 2^13, so two passes of a 7-bit radix sort on them beat a comparison sort
+    std::vector<u32> buffer(keys.size());
+    for (int shift = 11; shift < 25; shift += 7) {
+        std::array<u32, 129> starts{};
+        for (const u32 key: keys)
+            ++starts[(key >> shift & 127) + 1];
+        for (int b = 0; b < 128; ++b)
+            starts[b + 1] += starts[b];
+        for (const u32 key: keys)
+            buffer[starts[key >> shift & 127]++] = key;
+        keys.swap(buffer);
+    }
+
+    sorted_combos.reserve(keys.size());
+    for (const u32 key: keys)
+        sorted_combos.push_back(key & 2047);
+}
+
+u64 BoardEval::GetBoardMask() const {
+    return board_mask;
+}
+
+std::span<const u16> BoardEval::GetRanks() const {
+    return ranks;
+}
+
+int BoardEval::GetRank(const int combo) const {
+    return ranks[combo];
+}
+
+std::span<const u16> BoardEval::GetSortedCombos() const {
+    return sorted_combos;
+}
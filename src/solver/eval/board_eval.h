@@ -0,0 +1,56 @@
+#ifndef BOARD_EVAL_H
+#define BOARD_EVAL_H
+
+#include "solver/eval/eval.h"
+#include "solver/utils/utils.h"
+
+// Ranks every two-card combo on a fixed board in one pass. The board's suits and rank counts are
+// worked out once, and each combo only adds its own two cards, so a range-vs-range showdown on
+// a board costs one table lookup per combo.
+class BoardEval {
+    u64 board_mask;
+    std::array<u16, Utils::NUM_COMBOS> ranks;
+    std::vector<u16> sorted_combos;
+
+public:
+    /**
+     * Evaluate every combo on a board.
+     * @param board 3 to 5 cards, e.g. the output of Utils::ParseCards
+     */
+    explicit BoardEval(std::span<const u32> board);
+
+    /**
+     * Evaluate every combo on a board.
+     * @param board_mask mask of the 3 to 5 board cards, as returned by Utils::CardsToMask;
+     *                   throws std::invalid_argument if any bit above the 52 cards is set
+     */
+    explicit BoardEval(u64 board_mask);
+
+    /**
+     * Returns the board this was built for.
+     * @return mask of the board cards
+     */
+    [[nodiscard]] u64 GetBoardMask() const;
+
+    /**
+     * Returns the rank (as in Eval::GetBestHand) of every combo.
+     * @return ranks indexed by Utils::ComboIndex, with 0 for combos that use a board card
+     */
+    [[nodiscard]] std::span<const u16> GetRanks() const;
+
+    /**
+     * Returns the rank of one combo.
+     * @param combo index of the combo, as returned by Utils::ComboIndex
+     * @return the rank of the combo, or 0 if it uses a board card
+     */
+    [[nodiscard]] int GetRank(int combo) const;
+
+    /**
+     * Returns the combos that don't use a board card, from strongest to weakest. Combos of equal
+     * rank are adjacent, so a showdown against a whole range is a single sweep over this.
+     * @return combo indices sorted by rank
+     */
+    [[nodiscard]] std::span<const u16> GetSortedCombos() const;
+};
+
+#endif //BOARD_EVAL_H
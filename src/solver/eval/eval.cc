@@ -1,14 +1,12 @@
 #include "solver/eval/eval.h"
 #include "solver/utils/utils.h"
+#include <algorithm>
 #include <bit>
-#include <unordered_map>
+#include <stdexcept>
 
-Eval::Eval() : flushes{}, straights_and_high_cards{} {
-    InitLookupTables();
-    InitPrimeToIndex();
-}
-
-void Eval::InitLookupTables() {
+constexpr std::pair<std::array<u16, Eval::TABLE_SIZE>, std::array<u16, Eval::TABLE_SIZE> >
+Eval::InitLookupTables() {
+    std::array<u16, TABLE_SIZE> flushes{}, straights_and_high_cards{};
     int contiguous_cnt = 1;
     int non_contiguous_cnt = 1;
 
@@ -28,14 +26,30 @@ void Eval::InitLookupTables() {
 
     flushes[4111] = 10;
     straights_and_high_cards[4111] = 1609;
+
+    return {flushes, straights_and_high_cards};
 }
 
-void Eval::InitPrimeToIndex() {
+constexpr std::array<u16, Eval::TABLE_SIZE> Eval::flushes = InitLookupTables().first;
+constexpr std::array<u16, Eval::TABLE_SIZE> Eval::straights_and_high_cards =
+        InitLookupTables().second;
+
+// A hand's prime product and index, packed into one sort key.
+static constexpr u64 MakeKey(const int primes, const int index) {
+    return static_cast<u64>(primes) << 16 | static_cast<u64>(index);
+}
+
+constexpr Eval::PrimeProducts Eval::InitPrimeProducts() {
+    // each product in the high bits and its index in the low ones, so that sorting the keys
+    // sorts by product
+    std::array<u64, NUM_PRIME_PRODUCTS> primes_to_index{};
+    size_t n = 0;
+    const auto &p = Utils::PRIMES;
     int quads_cnt = 1;
     for (int a = 12; a >= 0; --a) {
         for (int b = 12; b >= 0; --b) {
             if (a == b) continue;
-            primes_to_index[Utils::PRIMES[a] * Utils::PRIMES[a] * Utils::PRIMES[a] * Utils::PRIMES[a] * Utils::PRIMES[b]] = 10 + quads_cnt;
+            primes_to_index[n++] = MakeKey(p[a] * p[a] * p[a] * p[a] * p[b], 10 + quads_cnt);
             ++quads_cnt;
         }
     }
@@ -44,7 +58,7 @@ void Eval::InitPrimeToIndex() {
     for (int a = 12; a >= 0; --a) {
         for (int b = 12; b >= 0; --b) {
             if (a == b) continue;
-            primes_to_index[Utils::PRIMES[a] * Utils::PRIMES[a] * Utils::PRIMES[a] * Utils::PRIMES[b] * Utils::PRIMES[b]] = 166 + boats_cnt;
+            primes_to_index[n++] = MakeKey(p[a] * p[a] * p[a] * p[b] * p[b], 166 + boats_cnt);
             ++boats_cnt;
         }
     }
@@ -54,7 +68,7 @@ void Eval::InitPrimeToIndex() {
         for (int b = 12; b >= 0; --b) {
             for (int c = b - 1; c >= 0; --c) {
                 if (a == b || b == c || a == c) continue;
-                primes_to_index[Utils::PRIMES[a] * Utils::PRIMES[a] * Utils::PRIMES[a] * Utils::PRIMES[b] * Utils::PRIMES[c]] = 1609 + trips_cnt;
+                primes_to_index[n++] = MakeKey(p[a] * p[a] * p[a] * p[b] * p[c], 1609 + trips_cnt);
                 ++trips_cnt;
             }
         }
@@ -65,7 +79,8 @@ void Eval::InitPrimeToIndex() {
         for (int b = a - 1; b >= 0; --b) {
             for (int c = 12; c >= 0; --c) {
                 if (a == b || b == c || a == c) continue;
-                primes_to_index[Utils::PRIMES[a] * Utils::PRIMES[a] * Utils::PRIMES[b] * Utils::PRIMES[b] * Utils::PRIMES[c]] = 2467 + two_pairs_cnt;
+                primes_to_index[n++] = MakeKey(p[a] * p[a] * p[b] * p[b] * p[c],
+                                               2467 + two_pairs_cnt);
                 ++two_pairs_cnt;
             }
         }
@@ -77,44 +92,207 @@ void Eval::InitPrimeToIndex() {
             for (int c = b - 1; c >= 0; --c) {
                 for (int d = c - 1; d >= 0; --d) {
                     if (a == b || a == c || a == d || b == c || b == d || c == d) continue;
-                    primes_to_index[Utils::PRIMES[a] * Utils::PRIMES[a] * Utils::PRIMES[b] * Utils::PRIMES[c] * Utils::PRIMES[d]] = 3325 + pairs_cnt;
+                    primes_to_index[n++] = MakeKey(p[a] * p[a] * p[b] * p[c] * p[d],
+                                                   3325 + pairs_cnt);
                     ++pairs_cnt;
                 }
             }
         }
     }
+
+    std::sort(primes_to_index.begin(), primes_to_index.end());
+
+    PrimeProducts prime_products{};
+    for (size_t i = 0; i < NUM_PRIME_PRODUCTS; ++i) {
+        prime_products.products[i] = static_cast<u32>(primes_to_index[i] >> 16);
+        prime_products.indices[i] = static_cast<u16>(primes_to_index[i]);
+    }
+
+    return prime_products;
 }
 
-int Eval::EvaluateHand(const std::vector<u32>& cards) {
-    const u32 suit = cards[0] & cards[1] & cards[2] & cards[3] & cards[4] & Utils::CARD_SUIT;
-    const u32 bitmask = (cards[0] | cards[1] | cards[2] | cards[3] | cards[4]) >> 16;
+constexpr Eval::PrimeProducts Eval::prime_products = InitPrimeProducts();
 
-    if (suit)
-        return flushes[bitmask];
-    if (straights_and_high_cards[bitmask])
-        return straights_and_high_cards[bitmask];
+constexpr std::array<u16, Eval::FLUSH_TABLE_SIZE> Eval::InitBestFlushes() {
+    std::array<u16, FLUSH_TABLE_SIZE> best_flushes{};
 
-    const u32 primes = (cards[0] & Utils::CARD_PRIME) * (cards[1] & Utils::CARD_PRIME) * (cards[2] & Utils::CARD_PRIME) *
-                 (cards[3] & Utils::CARD_PRIME) * (cards[4] & Utils::CARD_PRIME);
+    for (u32 bitmask = 0; bitmask < FLUSH_TABLE_SIZE; ++bitmask) {
+        if (std::popcount(bitmask) < 5) continue;
 
-    return primes_to_index[primes];
+        // the 5 highest ranks, unless a straight flush fits in the suit
+        u32 high_cards = bitmask;
+        while (std::popcount(high_cards) > 5)
+            high_cards &= high_cards - 1;
+        u16 best = flushes[high_cards];
+
+        for (u32 straight = 7936; straight >= 31; straight >>= 1)
+            if ((bitmask & straight) == straight)
+                best = std::min(best, flushes[straight]);
+        if ((bitmask & 4111) == 4111)
+            best = std::min(best, flushes[4111]);
+
+        best_flushes[bitmask] = best;
+    }
+
+    return best_flushes;
 }
 
-int Eval::GetBestHand(const std::vector<u32>& cards) {
-    int best = INT_MAX;
-
-    for (int i = 0; i < 7; ++i) {
-        for (int j = i + 1; j < 7; ++j) {
-            for (int k = j + 1; k < 7; ++k) {
-                for (int l = k + 1; l < 7; ++l) {
-                    for (int m = l + 1; m < 7; ++m) {
-                        std::vector<u32> hand = {cards[i], cards[j], cards[k], cards[l], cards[m]};
-                        best = std::min(best, EvaluateHand(hand));
-                    }
-                }
+constexpr std::array<u16, Eval::FLUSH_TABLE_SIZE> Eval::best_flushes = InitBestFlushes();
+
+constexpr std::array<std::array<std::array<u16, 8>, 8>, 13> Eval::InitRankCountOffsets() {
+    // ways[r][k] = number of ways to place k cards among r ranks, at most 4 per rank
+    std::array<std::array<int, 8>, 14> ways{};
+    ways[0][0] = 1;
+    for (int r = 1; r <= 13; ++r)
+        for (int k = 0; k < 8; ++k)
+            for (int c = 0; c <= std::min(4, k); ++c)
+                ways[r][k] += ways[r - 1][k - c];
+
+    // Ranks are numbered from the ace down. Holding c cards of rank r skips every multiset that
+    // holds fewer of rank r and agrees on the higher ranks.
+    std::array<std::array<std::array<u16, 8>, 8>, 13> rank_count_offsets{};
+    for (int r = 0; r < 13; ++r)
+        for (int k = 0; k < 8; ++k)
+            for (int c = 1; c <= std::min(4, k); ++c)
+                rank_count_offsets[r][k][c] = rank_count_offsets[r][k][c - 1] + ways[r][k - c + 1];
+
+    return rank_count_offsets;
+}
+
+constexpr std::array<std::array<std::array<u16, 8>, 8>, 13> Eval::rank_count_offsets =
+        InitRankCountOffsets();
+
+int Eval::EvaluateRankCounts(const std::array<int, 13>& counts) {
+    u32 bitmask = 0, primes = 1;
+    bool unique = true;
+
+    for (int r = 0; r < 13; ++r) {
+        if (counts[r]) bitmask |= 1 << r;
+        if (counts[r] > 1) unique = false;
+        for (int c = 0; c < counts[r]; ++c)
+            primes *= Utils::PRIMES[r];
+    }
+
+    return unique ? straights_and_high_cards[bitmask] : LookupPrimes(primes);
+}
+
+int Eval::EvaluateBestRankCounts(const std::array<int, 13>& counts) {
+    u32 bitmask = 0;
+    int num_pairs = 0, num_trips = 0, num_quads = 0;
+    for (int r = 0; r < 13; ++r) {
+        if (counts[r]) bitmask |= 1 << r;
+        num_pairs += counts[r] >= 2;
+        num_trips += counts[r] >= 3;
+        num_quads += counts[r] >= 4;
+    }
+
+    // Pick the 5 cards category by category, from the strongest down: take(least, count, n)
+    // takes count cards of each of the n highest ranks holding at least least cards that
+    // aren't taken yet.
+    std::array<int, 13> hand{};
+    int cards_left = 5;
+    const auto take = [&](const int least, const int count, int n) {
+        for (int r = 12; r >= 0 && n > 0; --r)
+            if (hand[r] == 0 && counts[r] >= least) {
+                hand[r] = count;
+                cards_left -= count;
+                --n;
             }
+    };
+
+    if (num_quads) {
+        take(4, 4, 1);
+        take(1, 1, 1);
+    } else if (num_trips && num_pairs >= 2) {
+        take(3, 3, 1);
+        take(2, 2, 1);
+    } else {
+        for (u32 straight = 7936; straight >= 31; straight >>= 1)
+            if ((bitmask & straight) == straight)
+                return straights_and_high_cards[straight];
+        if ((bitmask & 4111) == 4111)
+            return straights_and_high_cards[4111];
+
+        if (num_trips) {
+            take(3, 3, 1);
+            take(1, 1, 2);
+        } else if (num_pairs >= 2) {
+            take(2, 2, 2);
+            take(1, 1, 1);
+        } else if (num_pairs) {
+            take(2, 2, 1);
+            take(1, 1, 3);
+        } else
+            take(1, 1, 5);
+    }
+
+    return EvaluateRankCounts(hand);
+}
+
+std::array<u16, Eval::NON_FLUSH_TABLE_SIZE> Eval::InitNonFlushes() {
+    std::array<u16, NON_FLUSH_TABLE_SIZE> non_flushes{};
+    std::array<int, 13> counts{};
+
+    // every multiset of num_cards ranks, choosing the counts of rank r and below
+    const auto visit = [&](auto &&self, const int r, const int cards_left, const int num_cards,
+                           const u64 rank_counts) -> void {
+        if (r < 0) {
+            if (cards_left == 0)
+                non_flushes[HashRankCounts(rank_counts, num_cards)] =
+                        EvaluateBestRankCounts(counts);
+            return;
         }
+
+        for (int c = 0; c <= std::min(4, cards_left); ++c) {
+            counts[r] = c;
+            self(self, r - 1, cards_left - c, num_cards,
+                 rank_counts | static_cast<u64>(c) << 4 * r);
+        }
+        counts[r] = 0;
+    };
+
+    for (int num_cards = 5; num_cards <= 7; ++num_cards)
+        visit(visit, 12, num_cards, num_cards, 0);
+
+    return non_flushes;
+}
+
+int Eval::EvaluateHand(const std::span<const u32> cards) const {
+    if (cards.size() != 5)
+        throw std::invalid_argument("EvaluateHand takes 5 cards");
+
+    return EvaluateHand(cards[0], cards[1], cards[2], cards[3], cards[4]);
+}
+
+int Eval::GetBestHand(const std::span<const u32> cards) const {
+    if (cards.size() < 5 || cards.size() > 7)
+        throw std::invalid_argument("GetBestHand takes 5 to 7 cards");
+
+    return BestHand(cards.data(), static_cast<int>(cards.size()));
+}
+
+void Eval::GetBestHands(const std::span<const u32> cards, const int cards_per_hand,
+                        const std::span<u16> ranks) const {
+    if (cards_per_hand < 5 || cards_per_hand > 7)
+        throw std::invalid_argument("GetBestHands takes 5 to 7 cards per hand");
+    if (cards.size() != ranks.size() * cards_per_hand)
+        throw std::invalid_argument("GetBestHands needs cards_per_hand cards for every rank");
+
+    size_t done = 0;
+    if (HasAvx2()) {
+        done = ranks.size() / 8 * 8;
+        GetBestHandsAvx2(cards.data(), cards_per_hand, ranks.data(), done);
     }
 
-    return best;
+    for (size_t i = done; i < ranks.size(); ++i)
+        ranks[i] = BestHand(cards.data() + i * cards_per_hand, cards_per_hand);
+}
+
+bool Eval::HasAvx2() {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+#else
+    return false;
+#endif
 }
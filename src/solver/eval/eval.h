@@ -3,8 +3,11 @@
 
 #include <cstdint>
 #include <array>
-#include <unordered_map>
+#include <bit>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 // Use Cactus Kev's representation for cards:
@@ -17,6 +20,8 @@
 // b = bit turned on depending on rank of card
 //
 using u32 = uint32_t;
+using u64 = uint64_t;
+using u16 = uint16_t;
 
 // Let a_1, a_2, ..., a_7462 be the sequence of distinct hands in No-Limit Texas
 // Hold 'em, ordered by decreasing strength.
@@ -40,14 +45,58 @@ using u32 = uint32_t;
 
 class Eval {
 private:
-    // Lookup tables and map
+    // Same masks as Utils::CARD_SUIT and Utils::CARD_PRIME, which can't be included here.
+    static constexpr u32 CARD_SUIT = 61440;
+    static constexpr u32 CARD_PRIME = 63;
+
+    // Lookup tables. These are built at compile time, except non_flushes which is built on first
+    // use, and never written afterwards, so constructing an Eval is free, nothing runs before
+    // main, and one evaluator can be shared by any number of threads. Indices fit in 16 bits,
+    // which keeps every table in L1/L2. The tables the AVX2 kernel gathers from (best_flushes,
+    // non_flushes and rank_count_offsets) have a spare entry at the end, so it can read any
+    // entry with a 32-bit gather without running off the table.
     static constexpr size_t TABLE_SIZE = 7937;
-    std::array<int, TABLE_SIZE> flushes;
-    std::array<int, TABLE_SIZE> straights_and_high_cards;
-    std::unordered_map<u32, int> primes_to_index;
+    static const std::array<u16, TABLE_SIZE> flushes;
+    static const std::array<u16, TABLE_SIZE> straights_and_high_cards;
+
+    // The prime products of the 4888 hands with a repeated rank, in increasing order, and the
+    // index of each. Looked up by a branch-free binary search in LookupPrimes.
+    static constexpr size_t NUM_PRIME_PRODUCTS = 4888;
+    struct PrimeProducts {
+        std::array<u32, NUM_PRIME_PRODUCTS> products;
+        std::array<u16, NUM_PRIME_PRODUCTS> indices;
+    };
+    static const PrimeProducts prime_products;
+
+    // Tables for the direct 6- and 7-card evaluator.
+    // best_flushes maps a 13-bit mask of the ranks held in one suit (at least 5 of them) to the
+    // best flush inside it. non_flushes maps a multiset of 5 to 7 ranks, numbered densely by
+    // HashRankCounts, to the best 5-card hand that can be made from it ignoring suits.
+    static constexpr size_t FLUSH_TABLE_SIZE = 8192 + 1;
+    static constexpr size_t NON_FLUSH_TABLE_SIZE = 6175 + 18395 + 49205 + 1;
+    static const std::array<u16, FLUSH_TABLE_SIZE> best_flushes;
+    // Returns non_flushes, building it the first time. It is too large to build at compile
+    // time, and building it before main would delay every program that links the evaluator.
+    static const std::array<u16, NON_FLUSH_TABLE_SIZE>& GetNonFlushes();
+
+    // rank_count_offsets[r][k][c] is what HashRankCounts adds for c cards of rank r when k cards
+    // are left to place among ranks 0..r. c only goes up to 4; the padding to 8 lets the AVX2
+    // kernel index it with shifts.
+    static const std::array<std::array<std::array<u16, 8>, 8>, 13> rank_count_offsets;
 
 public:
-    Eval();
+    // Cards added one at a time, kept the way GetBestHand looks them up: the ranks held in each
+    // suit and the number of cards of each rank. Lets callers do the work for cards shared by
+    // many hands (e.g. a board) once.
+    struct PartialHand {
+        std::array<u32, 4> suits{};
+        u64 rank_counts = 0;
+        int num_cards = 0;
+
+        void Add(u32 card);
+    };
+
+    constexpr Eval() = default;
 
     // Takes 5 cards represented as u32's and returns the index of the corresponding
     // hand.
@@ -56,17 +105,169 @@ public:
     //                    ParseCard("Qh"),
     //                    ParseCard("Jh"),
     //                    ParseCard("Th")}) = 1, since this is a Royal Flush.
-    int EvaluateHand(const std::vector<u32>& cards);
+    // Accepts any contiguous container (std::vector, std::array, C array) without copying.
+    [[nodiscard]] int EvaluateHand(std::span<const u32> cards) const;
+
+    // Fixed-size EvaluateHand, defined inline so solver loops can inline the lookups.
+    [[nodiscard]] int EvaluateHand(u32 c1, u32 c2, u32 c3, u32 c4, u32 c5) const;
+
+    // Returns the index of the best 5-card hand that can be made from 5, 6 or 7 cards. This
+    // looks the hand up directly instead of evaluating every 5-card subset, and agrees with
+    // EvaluateHand on every subset.
+    [[nodiscard]] int GetBestHand(std::span<const u32> cards) const;
+
+    // Fixed-size GetBestHand, defined inline; N is checked at compile time.
+    template<size_t N>
+    [[nodiscard]] int GetBestHand(const std::array<u32, N>& cards) const;
+
+    // GetBestHand on the cards added to hand, which must number 5 to 7. Defined inline.
+    [[nodiscard]] int GetBestHand(const PartialHand& hand) const;
+
+    // Returns the index of the best flush in a suit holding the ranks set in suit_ranks (a
+    // 13-bit mask like bits 16-28 of a card), or 0 if it holds fewer than 5 ranks.
+    [[nodiscard]] int GetBestFlush(u32 suit_ranks) const;
 
-    // Uses EvaluateHand to get the best possible number for 7 cards
-    int GetBestHand(const std::vector<u32>& cards);
+    // Batch version of GetBestHand. cards holds ranks.size() hands of cards_per_hand (5 to 7)
+    // cards each, back to back, and ranks[i] is set to the index of hand i. Uses the AVX2 kernel
+    // when the CPU supports it and a scalar loop otherwise; both give the same results.
+    void GetBestHands(std::span<const u32> cards, int cards_per_hand, std::span<u16> ranks) const;
 
 private:
-    // Initialize lookup tables flushes and straights_and_high_cards.
-    void InitLookupTables();
+    // Build lookup tables {flushes, straights_and_high_cards}.
+    static constexpr std::pair<std::array<u16, TABLE_SIZE>, std::array<u16, TABLE_SIZE> >
+    InitLookupTables();
+
+    // Build lookup table prime_products.
+    static constexpr PrimeProducts InitPrimeProducts();
+
+    // Build lookup table best_flushes.
+    static constexpr std::array<u16, FLUSH_TABLE_SIZE> InitBestFlushes();
+
+    // Build lookup table rank_count_offsets.
+    static constexpr std::array<std::array<std::array<u16, 8>, 8>, 13> InitRankCountOffsets();
+
+    // Build lookup table non_flushes.
+    static std::array<u16, NON_FLUSH_TABLE_SIZE> InitNonFlushes();
+
+    // Return the index of the hand whose prime product is primes. Throws std::invalid_argument
+    // if no hand has that product (e.g. five cards of one rank).
+    static int LookupPrimes(u32 primes);
+
+    // Map the rank counts of num_cards cards (4 bits per rank, deuce in the lowest bits) to
+    // their index in non_flushes.
+    static int HashRankCounts(u64 rank_counts, int num_cards);
+
+    // GetBestHand on num_cards (5 to 7) cards starting at cards.
+    static int BestHand(const u32* cards, int num_cards);
+
+    // GetBestHand on a PartialHand of 5 to 7 cards.
+    static int BestHand(const PartialHand& hand);
+
+    // Whether this CPU can run GetBestHandsAvx2.
+    static bool HasAvx2();
+
+    // GetBestHands for num_hands hands using AVX2, 8 hands at a time. Defined in eval_avx2.cc.
+    static void GetBestHandsAvx2(const u32* cards, int cards_per_hand, u16* ranks,
+                                 size_t num_hands);
 
-    // Initialize lookup map primes_to_index.
-    void InitPrimeToIndex();
+    // Return the index of 5 cards with the given rank counts, assuming they are not a flush.
+    static int EvaluateRankCounts(const std::array<int, 13>& counts);
+
+    // Return the index of the best 5-card hand that can be made from the given rank counts (5 to
+    // 7 cards), assuming there is no flush.
+    static int EvaluateBestRankCounts(const std::array<int, 13>& counts);
 };
 
+inline int Eval::EvaluateHand(const u32 c1, const u32 c2, const u32 c3, const u32 c4,
+                              const u32 c5) const {
+    const u32 suit = c1 & c2 & c3 & c4 & c5 & CARD_SUIT;
+    const u32 bitmask = (c1 | c2 | c3 | c4 | c5) >> 16;
+
+    if (suit)
+        return flushes[bitmask];
+    if (straights_and_high_cards[bitmask])
+        return straights_and_high_cards[bitmask];
+
+    const u32 primes = (c1 & CARD_PRIME) * (c2 & CARD_PRIME) * (c3 & CARD_PRIME) *
+                       (c4 & CARD_PRIME) * (c5 & CARD_PRIME);
+
+    return LookupPrimes(primes);
+}
+
+inline int Eval::LookupPrimes(const u32 primes) {
+    const u32* first = prime_products.products.data();
+    size_t length = NUM_PRIME_PRODUCTS;
+
+    // the last product <= primes; the conditional compiles to a cmov
+    while (length > 1) {
+        const size_t half = length / 2;
+        first = first[half] <= primes ? first + half : first;
+        length -= half;
+    }
+
+    if (*first != primes)
+        throw std::invalid_argument("invalid hand");
+
+    return prime_products.indices[first - prime_products.products.data()];
+}
+
+template<size_t N>
+int Eval::GetBestHand(const std::array<u32, N>& cards) const {
+    static_assert(N >= 5 && N <= 7, "GetBestHand takes 5 to 7 cards");
+    if constexpr (N == 5)
+        return EvaluateHand(cards[0], cards[1], cards[2], cards[3], cards[4]);
+    else
+        return BestHand(cards.data(), N);
+}
+
+inline int Eval::HashRankCounts(const u64 rank_counts, const int num_cards) {
+    // 5-card multisets come first, then 6-card, then 7-card
+    int index = num_cards == 5 ? 0 : num_cards == 6 ? 6175 : 6175 + 18395;
+    int cards_left = num_cards;
+
+    for (int r = 12; r >= 0 && cards_left; --r) {
+        const int count = static_cast<int>(rank_counts >> 4 * r & 15);
+        index += rank_count_offsets[r][cards_left][count];
+        cards_left -= count;
+    }
+
+    return index;
+}
+
+inline void Eval::PartialHand::Add(const u32 card) {
+    suits[std::countr_zero((card & CARD_SUIT) >> 12)] |= card >> 16;
+    rank_counts += 1ULL << 4 * std::countr_zero(card >> 16);
+    ++num_cards;
+}
+
+inline int Eval::GetBestHand(const PartialHand& hand) const {
+    return BestHand(hand);
+}
+
+inline const std::array<u16, Eval::NON_FLUSH_TABLE_SIZE>& Eval::GetNonFlushes() {
+    static const std::array<u16, NON_FLUSH_TABLE_SIZE> non_flushes = InitNonFlushes();
+    return non_flushes;
+}
+
+inline int Eval::GetBestFlush(const u32 suit_ranks) const {
+    return best_flushes[suit_ranks];
+}
+
+inline int Eval::BestHand(const u32* cards, const int num_cards) {
+    PartialHand hand;
+    for (int i = 0; i < num_cards; ++i)
+        hand.Add(cards[i]);
+
+    return BestHand(hand);
+}
+
+inline int Eval::BestHand(const PartialHand& hand) {
+    // with at most 7 cards, a flush beats anything the other suits could make
+    for (const u32 suit: hand.suits)
+        if (std::popcount(suit) >= 5)
+            return best_flushes[suit];
+
+    return GetNonFlushes()[HashRankCounts(hand.rank_counts, hand.num_cards)];
+}
+
 #endif
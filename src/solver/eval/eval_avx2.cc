@@ -0,0 +1,98 @@
+#include "solver/eval/eval.h"
+
+// AVX2 kernel for Eval::GetBestHands. It runs the same flush check and rank-count hash as
+// Eval::BestHand on 8 hands at once, one hand per 32-bit lane. Only built for x86-64; elsewhere
+// Eval::HasAvx2 is false and this is never called.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+
+// Read table[index] for each lane of a u16 table. The tables have a spare entry at the end, so
+// the 32-bit loads never run off them.
+__attribute__((target("avx2")))
+static __m256i Gather16(const u16* table, const __m256i index) {
+    const __m256i words = _mm256_i32gather_epi32(reinterpret_cast<const int*>(table), index, 2);
+    return _mm256_and_si256(words, _mm256_set1_epi32(0xFFFF));
+}
+
+// Add a 0/1 bit vector to the bit-sliced counters ones, twos and fours.
+__attribute__((target("avx2")))
+static void AddBits(__m256i &ones, __m256i &twos, __m256i &fours, const __m256i bits) {
+    const __m256i carry = _mm256_and_si256(ones, bits);
+    ones = _mm256_xor_si256(ones, bits);
+    fours = _mm256_or_si256(fours, _mm256_and_si256(twos, carry));
+    twos = _mm256_xor_si256(twos, carry);
+}
+
+__attribute__((target("avx2")))
+void Eval::GetBestHandsAvx2(const u32* cards, const int cards_per_hand, u16* ranks,
+                            const size_t num_hands) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lanes = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                             _mm256_set1_epi32(cards_per_hand));
+    const int base = cards_per_hand == 5 ? 0 : cards_per_hand == 6 ? 6175 : 6175 + 18395;
+    const u16* offsets = &rank_count_offsets[0][0][0];
+    const u16* non_flush_table = GetNonFlushes().data();
+
+    for (size_t h = 0; h < num_hands; h += 8) {
+        const int* hand = reinterpret_cast<const int*>(cards + h * cards_per_hand);
+
+        // count ranks and suits, one bit per rank (or suit) in each of ones, twos and fours
+        __m256i card[7];
+        __m256i rank_ones = zero, rank_twos = zero, rank_fours = zero;
+        __m256i suit_ones = zero, suit_twos = zero, suit_fours = zero;
+        for (int j = 0; j < cards_per_hand; ++j) {
+            card[j] = _mm256_i32gather_epi32(hand + j, lanes, 4);
+            AddBits(rank_ones, rank_twos, rank_fours, _mm256_srli_epi32(card[j], 16));
+            AddBits(suit_ones, suit_twos, suit_fours,
+                    _mm256_and_si256(_mm256_srli_epi32(card[j], 12), _mm256_set1_epi32(15)));
+        }
+
+        // a suit with 5 to 7 cards has its fours bit and a ones or twos bit set
+        const __m256i flush_suit = _mm256_and_si256(suit_fours,
+                                                    _mm256_or_si256(suit_ones, suit_twos));
+        __m256i flush_bitmask = zero;
+        for (int j = 0; j < cards_per_hand; ++j) {
+            const __m256i suited = _mm256_cmpgt_epi32(
+                _mm256_and_si256(_mm256_srli_epi32(card[j], 12), flush_suit), zero);
+            flush_bitmask = _mm256_or_si256(
+                flush_bitmask, _mm256_and_si256(suited, _mm256_srli_epi32(card[j], 16)));
+        }
+
+        // HashRankCounts, walking the ranks from the ace down by shifting them into bit 31
+        __m256i index = _mm256_set1_epi32(base);
+        __m256i cards_left = _mm256_set1_epi32(cards_per_hand);
+        __m256i ones = _mm256_slli_epi32(rank_ones, 19);
+        __m256i twos = _mm256_slli_epi32(rank_twos, 19);
+        __m256i fours = _mm256_slli_epi32(rank_fours, 19);
+        for (int r = 12; r >= 0; --r) {
+            const __m256i count = _mm256_or_si256(
+                _mm256_srli_epi32(ones, 31),
+                _mm256_or_si256(_mm256_slli_epi32(_mm256_srli_epi32(twos, 31), 1),
+                                _mm256_slli_epi32(_mm256_srli_epi32(fours, 31), 2)));
+            const __m256i offset = _mm256_add_epi32(
+                _mm256_set1_epi32(r << 6),
+                _mm256_add_epi32(_mm256_slli_epi32(cards_left, 3), count));
+            index = _mm256_add_epi32(index, Gather16(offsets, offset));
+            cards_left = _mm256_sub_epi32(cards_left, count);
+            ones = _mm256_slli_epi32(ones, 1);
+            twos = _mm256_slli_epi32(twos, 1);
+            fours = _mm256_slli_epi32(fours, 1);
+        }
+
+        const __m256i is_flush = _mm256_cmpgt_epi32(flush_suit, zero);
+        const __m256i result = _mm256_blendv_epi8(Gather16(non_flush_table, index),
+                                                  Gather16(best_flushes.data(), flush_bitmask),
+                                                  is_flush);
+
+        const __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(result),
+                                                _mm256_extracti128_si256(result, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ranks + h), packed);
+    }
+}
+
+#else
+
+void Eval::GetBestHandsAvx2(const u32*, int, u16*, size_t) {
+}
+
+#endif
@@ -0,0 +1,51 @@
+#include "solver/eval/incremental_eval.h"
+#include <unordered_map>
+
+IncrementalEval::IncrementalEval() : tables(&GetTables()) {
+}
+
+const IncrementalEval::Tables& IncrementalEval::GetTables() {
+    static const Tables tables = InitTables();
+    return tables;
+}
+
+IncrementalEval::Tables IncrementalEval::InitTables() {
+    Tables tables;
+    constexpr Eval eval;
+
+    // Number the multisets breadth first, so nodes of k ranks come before nodes of k + 1. Each
+    // multiset is held as its rank counts, 4 bits per rank.
+    std::vector<u64> nodes = {0};
+    std::vector<int> num_cards = {0};
+    std::unordered_map<u64, u32> node_of = {{0, 0}};
+
+    for (u32 node = 0; node < nodes.size(); ++node) {
+        if (num_cards[node] >= 5) {
+            Eval::PartialHand hand;
+            hand.rank_counts = nodes[node];
+            hand.num_cards = num_cards[node];
+            tables.non_flush_ranks.push_back(eval.GetBestHand(hand));
+        } else {
+            tables.non_flush_ranks.push_back(0);
+        }
+        if (num_cards[node] == 7) continue;
+
+        for (int r = 0; r < 13; ++r) {
+            // a fifth card of one rank can't be dealt; leave it pointing back at the root
+            if ((nodes[node] >> 4 * r & 15) == 4) {
+                tables.transitions.push_back(0);
+                continue;
+            }
+
+            const u64 next = nodes[node] + (1ULL << 4 * r);
+            auto [it, inserted] = node_of.try_emplace(next, static_cast<u32>(nodes.size()));
+            if (inserted) {
+                nodes.push_back(next);
+                num_cards.push_back(num_cards[node] + 1);
+            }
+            tables.transitions.push_back(it->second);
+        }
+    }
+
+    return tables;
+}
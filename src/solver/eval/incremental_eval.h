@@ -0,0 +1,81 @@
+#ifndef INCREMENTAL_EVAL_H
+#define INCREMENTAL_EVAL_H
+
+#include "solver/eval/eval.h"
+#include <vector>
+
+// Evaluates hands one card at a time, for loops that deal many hands sharing their first cards
+// (e.g. every turn and river after a flop). A State holds the cards added so far, so a loop can
+// keep the state for a prefix and extend it: adding a card is a single load from a precomputed
+// "add one card" table, plus setting a bit for its suit.
+//
+// The table is a state machine over multisets of up to 7 ranks (76155 states); suits are only
+// needed for flushes and are tracked as one rank mask per suit. GetRank agrees with
+// Eval::GetBestHand.
+class IncrementalEval {
+public:
+    // The cards added so far.
+    struct State {
+        u32 node = 0; // the multiset of ranks, as a state of the table
+        std::array<u16, 4> suits{}; // the ranks held in each suit
+        // 4 bits per suit holding 3 plus its number of cards, so bit 3 of a suit is set once it
+        // has 5 cards (with at most 7 cards, only one suit can)
+        u16 suit_counts = 0x3333;
+    };
+
+private:
+    struct Tables {
+        // transitions[13 * node + r] is the node reached by adding a card of rank r to node, for
+        // nodes of fewer than 7 ranks.
+        std::vector<u32> transitions;
+        // Eval::GetBestHand of each node of 5 to 7 ranks, ignoring flushes; 0 for other nodes.
+        std::vector<u16> non_flush_ranks;
+    };
+
+    // The tables, shared by every IncrementalEval and built on first use.
+    const Tables* tables;
+
+    static const Tables& GetTables();
+
+    static Tables InitTables();
+
+public:
+    IncrementalEval();
+
+    /**
+     * Returns state with one more card.
+     * @param state the cards so far (at most 6)
+     * @param card the card to add, which must not be in state yet
+     * @return the new state
+     */
+    [[nodiscard]] State Add(State state, u32 card) const;
+
+    /**
+     * Returns the index of the best hand that can be made from the cards in state, as in
+     * Eval::GetBestHand.
+     * @param state 5 to 7 cards
+     * @return the index of the hand
+     */
+    [[nodiscard]] int GetRank(const State& state) const;
+};
+
+inline IncrementalEval::State IncrementalEval::Add(State state, const u32 card) const {
+    const int rank_index = std::countr_zero(card >> 16);
+    state.node = tables->transitions[13 * state.node + rank_index];
+    const int suit_index = std::countr_zero(card >> 12 & 15);
+    state.suits[suit_index] |= 1 << rank_index;
+    state.suit_counts += 1 << 4 * suit_index;
+    return state;
+}
+
+inline int IncrementalEval::GetRank(const State& state) const {
+    // with at most 7 cards, a flush beats anything the other suits could make
+    if (const int flush = state.suit_counts & 0x8888) {
+        constexpr Eval eval;
+        return eval.GetBestFlush(state.suits[std::countr_zero(static_cast<u32>(flush)) / 4]);
+    }
+
+    return tables->non_flush_ranks[state.node];
+}
+
+#endif //INCREMENTAL_EVAL_H
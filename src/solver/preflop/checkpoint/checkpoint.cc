@@ -0,0 +1,168 @@
+#include "solver/preflop/checkpoint/checkpoint.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+Checkpoint::Checkpoint(MappedFile file, const Header &header)
+    : file(std::move(file)), header(header) {
+    const std::span<const std::byte> data = this->file.GetData();
+    const auto *const node_data = reinterpret_cast<const Node *>(data.data() + sizeof(Header));
+    nodes = {node_data, header.num_nodes};
+
+    size_t num_actions = 0;
+    for (const Node &node: nodes)
+        num_actions += node.num_children;
+    actions = {reinterpret_cast<const ActionKind *>(node_data + header.num_nodes), num_actions};
+
+    const size_t offset = GetValuesOffset(header.num_nodes, num_actions);
+    regrets = data.subspan(offset, header.regret_size);
+    strategy_sums = data.subspan(offset + header.regret_size, header.sum_size);
+}
+
+size_t Checkpoint::GetValuesOffset(const size_t num_nodes, const size_t num_actions) {
+    const size_t end = sizeof(Header) + num_nodes * sizeof(Node) + num_actions;
+    return (end + InfosetStore::ALIGNMENT - 1) / InfosetStore::ALIGNMENT * InfosetStore::ALIGNMENT;
+}
+
+Checkpoint Checkpoint::Load(const std::string &path) {
+    MappedFile file(path);
+    const std::span<const std::byte> data = file.GetData();
+
+    Header header{};
+    if (data.size() < sizeof(Header))
+        throw std::runtime_error(path + " is not a checkpoint");
+    std::memcpy(&header, data.data(), sizeof(Header));
+    if (header.magic != MAGIC)
+        throw std::runtime_error(path + " is not a checkpoint");
+    if (header.version != VERSION)
+        throw std::runtime_error(path + " has version " + std::to_string(header.version) +
+                                 ", expected " + std::to_string(VERSION));
+    if (header.precision > static_cast<uint32_t>(InfosetStore::Precision::FIXED16))
+        throw std::runtime_error(path + " has an unknown precision");
+
+    // the tree must fit before its edges can be counted
+    const size_t tree_end = sizeof(Header) + static_cast<size_t>(header.num_nodes) * sizeof(Node);
+    if (data.size() < tree_end)
+        throw std::runtime_error(path + " has the wrong size");
+    size_t num_actions = 0;
+    for (uint32_t n = 0; n < header.num_nodes; ++n) {
+        Node node{};
+        std::memcpy(&node, data.data() + sizeof(Header) + n * sizeof(Node), sizeof(Node));
+        num_actions += node.num_children;
+    }
+
+    if (data.size() != GetValuesOffset(header.num_nodes, num_actions) + header.regret_size
+                       + header.sum_size)
+        throw std::runtime_error(path + " has the wrong size");
+
+    return {std::move(file), header};
+}
+
+void Checkpoint::Save(const std::string &path, const Data &data) {
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw std::runtime_error("can't open " + temporary);
+
+        const Header header = {
+            MAGIC, VERSION, static_cast<uint32_t>(data.precision),
+            static_cast<uint32_t>(data.nodes.size()), static_cast<uint32_t>(data.num_hands),
+            data.num_iterations, data.regrets.size(), data.strategy_sums.size(), data.config
+        };
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(data.nodes.data()),
+                  static_cast<std::streamsize>(data.nodes.size() * sizeof(Node)));
+        out.write(reinterpret_cast<const char *>(data.actions.data()),
+                  static_cast<std::streamsize>(data.actions.size()));
+
+        // pad so that the values are aligned in the mapping, as in the store
+        const size_t end = sizeof(Header) + data.nodes.size() * sizeof(Node) + data.actions.size();
+        const std::vector<char> padding(GetValuesOffset(data.nodes.size(), data.actions.size())
+                                        - end);
+        out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+        out.write(reinterpret_cast<const char *>(data.regrets.data()),
+                  static_cast<std::streamsize>(data.regrets.size()));
+        out.write(reinterpret_cast<const char *>(data.strategy_sums.data()),
+                  static_cast<std::streamsize>(data.strategy_sums.size()));
+        if (!out.flush())
+            throw std::runtime_error("can't write " + temporary);
+    }
+
+    if (std::rename(temporary.c_str(), path.c_str()) != 0)
+        throw std::runtime_error("can't replace " + path);
+}
+
+Checkpoint::ActionKind Checkpoint::GetActionKind(const PreflopAction &action) {
+    if (dynamic_cast<const Fold *>(&action))
+        return ActionKind::FOLD;
+    if (dynamic_cast<const Check *>(&action))
+        return ActionKind::CHECK;
+    if (dynamic_cast<const Call *>(&action))
+        return ActionKind::CALL;
+    if (dynamic_cast<const Bet *>(&action))
+        return ActionKind::BET;
+    if (dynamic_cast<const Raise *>(&action))
+        return ActionKind::RAISE;
+    if (dynamic_cast<const AllIn *>(&action))
+        return ActionKind::ALL_IN;
+    throw std::invalid_argument("unknown action");
+}
+
+CheckpointWriter::CheckpointWriter(std::string path)
+    : path(std::move(path)), thread(&CheckpointWriter::Loop, this) {
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    thread.join();
+}
+
+void CheckpointWriter::Submit(Checkpoint::Data data) {
+    {
+        std::lock_guard lock(mutex);
+        pending = std::move(data);
+    }
+    changed.notify_all();
+}
+
+void CheckpointWriter::Flush() {
+    std::unique_lock lock(mutex);
+    changed.wait(lock, [this] { return !pending && !writing; });
+    if (error)
+        std::rethrow_exception(std::exchange(error, nullptr));
+}
+
+void CheckpointWriter::Loop() {
+    std::unique_lock lock(mutex);
+    while (true) {
+        changed.wait(lock, [this] { return stopping || pending; });
+        if (!pending)
+            return;
+
+        Checkpoint::Data data = std::move(*pending);
+        pending.reset();
+        writing = true;
+        lock.unlock();
+
+        std::exception_ptr failure;
+        try {
+            Checkpoint::Save(path, data);
+        } catch (...) {
+            failure = std::current_exception();
+        }
+
+        lock.lock();
+        writing = false;
+        if (failure)
+            error = failure;
+        changed.notify_all();
+    }
+}
@@ -0,0 +1,221 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "solver/preflop/infoset_store/infoset_store.h"
+#include "solver/preflop/preflop_action/preflop_action.h"
+#include "solver/utils/mapped_file.h"
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * The training state of a PreflopSolver saved to disk: the game it solves, the shape of its
+ * betting tree, the number of iterations trained, and every regret and strategy sum. Loading maps
+ * the file, so even a large checkpoint opens instantly; nothing is replayed.
+ *
+ * File format, in native byte order (little-endian on every supported platform):
+ *   char     magic[8]         "GTOCKPT\0"
+ *   u32      version          VERSION
+ *   u32      precision        InfosetStore::Precision of the values
+ *   u32      num_nodes        nodes of the tree
+ *   u32      num_hands        hands per information set
+ *   i64      num_iterations   iterations trained
+ *   u64      regret_size      bytes of the regrets below
+ *   u64      sum_size         bytes of the strategy sums below
+ *   Config   config           the game
+ *   Node     nodes[num_nodes] the tree in depth-first order
+ *   u8       actions[]        kind of each edge, ordered by parent then position
+ *   padding                   to a multiple of 64 bytes
+ *   byte     regrets[regret_size]
+ *   byte     strategy_sums[sum_size]
+ * where the arrays are as InfosetStore::GetRegretData and GetStrategySumData return them.
+ */
+class Checkpoint {
+public:
+    static constexpr uint32_t VERSION = 2;
+
+    // The game a solver was built for.
+    struct Config {
+        double p1_stack_depth, p2_stack_depth, p1_equity_multiplier;
+        int32_t p1_position, p2_position, num_max_raises, reserved;
+
+        bool operator==(const Config &) const = default;
+    };
+
+    // A node of the betting tree, as in PreflopTree::TreeNode.
+    struct Node {
+        double p1_bet, p2_bet;
+        int32_t player;
+        uint8_t type, all_in;
+        uint16_t num_children;
+
+        bool operator==(const Node &) const = default;
+    };
+
+    // What an edge of the tree does; bets and raises are told apart by the child's bets.
+    enum class ActionKind : uint8_t {
+        FOLD,
+        CHECK,
+        CALL,
+        BET,
+        RAISE,
+        ALL_IN
+    };
+
+    // Everything a checkpoint holds, in memory.
+    struct Data {
+        Config config;
+        int64_t num_iterations;
+        InfosetStore::Precision precision;
+        int num_hands;
+        std::vector<Node> nodes;
+        std::vector<ActionKind> actions;
+        std::vector<std::byte> regrets, strategy_sums;
+    };
+
+private:
+    struct Header {
+        std::array<char, 8> magic;
+        uint32_t version, precision, num_nodes, num_hands;
+        int64_t num_iterations;
+        uint64_t regret_size, sum_size;
+        Config config;
+    };
+    static constexpr std::array<char, 8> MAGIC = {'G', 'T', 'O', 'C', 'K', 'P', 'T', '\0'};
+
+    MappedFile file;
+    Header header;
+    std::span<const Node> nodes;
+    std::span<const ActionKind> actions;
+    std::span<const std::byte> regrets, strategy_sums;
+
+    Checkpoint(MappedFile file, const Header &header);
+
+    // The offset of the regrets: the header, the tree, and padding.
+    static size_t GetValuesOffset(size_t num_nodes, size_t num_actions);
+
+public:
+    /**
+     * Map a checkpoint.
+     * @param path the file; throws std::runtime_error if it isn't a checkpoint of this version
+     * @return the checkpoint
+     */
+    static Checkpoint Load(const std::string &path);
+
+    /**
+     * Write a checkpoint. The file is written under a temporary name and renamed into place, so
+     * a crash mid-write leaves the previous checkpoint intact.
+     * @param path the file
+     * @param data the state to save
+     */
+    static void Save(const std::string &path, const Data &data);
+
+    /**
+     * Returns the kind of an action.
+     * @param action the action
+     * @return its kind
+     */
+    static ActionKind GetActionKind(const PreflopAction &action);
+
+    [[nodiscard]] const Config &GetConfig() const;
+
+    [[nodiscard]] int64_t GetNumIterations() const;
+
+    [[nodiscard]] InfosetStore::Precision GetPrecision() const;
+
+    [[nodiscard]] int GetNumHands() const;
+
+    [[nodiscard]] std::span<const Node> GetNodes() const;
+
+    [[nodiscard]] std::span<const ActionKind> GetActions() const;
+
+    // The raw values, as in InfosetStore::GetRegretData and GetStrategySumData.
+    [[nodiscard]] std::span<const std::byte> GetRegretData() const;
+
+    [[nodiscard]] std::span<const std::byte> GetStrategySumData() const;
+};
+
+/**
+ * Saves checkpoints on a background thread, so that training only pays for copying its state.
+ * At most one checkpoint waits to be written: a newer one replaces it.
+ */
+class CheckpointWriter {
+    std::string path;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::optional<Checkpoint::Data> pending;
+    bool writing = false, stopping = false;
+    std::exception_ptr error;
+    std::thread thread;
+
+    // Body of the writer thread.
+    void Loop();
+
+public:
+    /**
+     * Start the writer.
+     * @param path the file each checkpoint replaces
+     */
+    explicit CheckpointWriter(std::string path);
+
+    CheckpointWriter(const CheckpointWriter &) = delete;
+    CheckpointWriter &operator=(const CheckpointWriter &) = delete;
+
+    // Writes the last pending checkpoint, then stops.
+    ~CheckpointWriter();
+
+    /**
+     * Queue a checkpoint to be written, replacing any still waiting.
+     * @param data the state to save
+     */
+    void Submit(Checkpoint::Data data);
+
+    /**
+     * Wait until every queued checkpoint is written. If a write failed, its exception is
+     * rethrown here.
+     */
+    void Flush();
+};
+
+inline const Checkpoint::Config &Checkpoint::GetConfig() const {
+    return header.config;
+}
+
+inline int64_t Checkpoint::GetNumIterations() const {
+    return header.num_iterations;
+}
+
+inline InfosetStore::Precision Checkpoint::GetPrecision() const {
+    return static_cast<InfosetStore::Precision>(header.precision);
+}
+
+inline int Checkpoint::GetNumHands() const {
+    return static_cast<int>(header.num_hands);
+}
+
+inline std::span<const Checkpoint::Node> Checkpoint::GetNodes() const {
+    return nodes;
+}
+
+inline std::span<const Checkpoint::ActionKind> Checkpoint::GetActions() const {
+    return actions;
+}
+
+inline std::span<const std::byte> Checkpoint::GetRegretData() const {
+    return regrets;
+}
+
+inline std::span<const std::byte> Checkpoint::GetStrategySumData() const {
+    return strategy_sums;
+}
+
+#endif //CHECKPOINT_H
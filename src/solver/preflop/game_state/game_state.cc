@@ -3,55 +3,88 @@
 //
 
 #include "game_state.h"
+#include <algorithm>
+#include <stdexcept>
+
+// Amount posted before any action by a player in `position`.
+static double GetBlind(const int position) {
+    if (position == 0) return 0.5;
+    if (position == 1) return 1;
+    return 0;
+}
 
 GameState::GameState(const int player_to_move, const int p1_position, const int p2_position,
                      const double p1_stack_depth, const double p2_stack_depth,
                      std::vector<std::shared_ptr<PreflopAction> > history, const int max_num_raises)
     : player_to_move(player_to_move), max_num_raises(max_num_raises), p1_position(p1_position),
       p2_position(p2_position), p1_stack_depth(p1_stack_depth), p2_stack_depth(p2_stack_depth),
-      history(std::move(history)) {
+      pot(std::min(GetBlind(p1_position), p1_stack_depth),
+          std::min(GetBlind(p2_position), p2_stack_depth)) {
+    // the players alternate, so the first action was made by player_to_move iff the history has
+    // even length
+    if (history.size() % 2 == 1)
+        this->player_to_move = 3 - player_to_move;
+    for (const auto &action: history)
+        Apply(action);
 }
 
 bool GameState::IsTerminal() const {
-    return !history.empty() && history.back()->IsTerminal(*this);
+    return terminal;
 }
 
-std::pair<double, double> GameState::GetTotalBets() {
-    double p1_bet = 0, p2_bet = 0;
-    if (p1_position == 0) p1_bet = 0.5;
-    else if (p1_position == 1) p1_bet = 1;
-    else p1_bet = 0;
-    if (p2_position == 0) p2_bet = 0.5;
-    else if (p2_position == 1) p2_bet = 1;
-    else p2_bet = 0;
-
-    GameState prev_state = GetPreviousGameState();
-    for (int i = static_cast<int>(history.size()) - 1; i >= 0; --i) {
-        if (player_to_move == 1)
-            p1_bet += history[i]->GetBetAmount(prev_state);
-        else
-            p2_bet += history[i]->GetBetAmount(prev_state);
-        prev_state = prev_state.GetPreviousGameState();
-    }
-
-    return std::make_pair(p1_bet, p2_bet);
+std::pair<double, double> GameState::GetTotalBets() const {
+    return pot;
 }
 
 bool GameState::CanRaise() const {
     int cnt = 0;
     for (const auto &action: history)
-        cnt += action == std::dynamic_pointer_cast<Raise>(action)
-                || action == std::dynamic_pointer_cast<Bet>(action);
-    return cnt < max_num_raises;
+        cnt += dynamic_cast<const Raise *>(action.get()) != nullptr
+                || dynamic_cast<const Bet *>(action.get()) != nullptr
+                || dynamic_cast<const AllIn *>(action.get()) != nullptr;
+    return cnt < max_num_raises && std::max(pot.first, pot.second) < GetEffectiveStack();
 }
 
 double GameState::GetLastRaise() const {
+    return last_raise;
+}
+
+double GameState::GetChipsRemaining(const int player) const {
+    return player == 1 ? p1_stack_depth - pot.first : p2_stack_depth - pot.second;
+}
+
+double GameState::GetEffectiveStack() const {
+    return std::min(p1_stack_depth, p2_stack_depth);
+}
+
+double GameState::GetBet(const int player) const {
+    return player == 1 ? pot.first : pot.second;
+}
+
+GameState GameState::GetPreviousGameState() const {
     if (history.empty())
-        return 1;
+        throw std::logic_error("no previous state");
 
-    return abs(pot.first - pot.second);
+    std::vector<std::shared_ptr<PreflopAction> > previous(history.begin(), history.end() - 1);
+    return {3 - player_to_move, p1_position, p2_position, p1_stack_depth, p2_stack_depth,
+            std::move(previous), max_num_raises};
 }
 
-double GameState::GetChipsRemaining(const int player) const {
-    return player == 1 ? p1_stack_depth : p2_stack_depth;
+GameState GameState::GetNextGameState(const std::shared_ptr<PreflopAction> &action) const {
+    GameState next = *this;
+    next.Apply(action);
+    return next;
+}
+
+void GameState::Apply(const std::shared_ptr<PreflopAction> &action) {
+    const double max_bet = std::max(pot.first, pot.second);
+    const double amount = action->GetBetAmount(*this);
+    terminal = action->IsTerminal(*this);
+
+    double &bet = player_to_move == 1 ? pot.first : pot.second;
+    bet += amount;
+    last_raise = std::max(last_raise, bet - max_bet);
+
+    history.push_back(action);
+    player_to_move = 3 - player_to_move;
 }
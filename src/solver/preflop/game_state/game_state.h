@@ -4,6 +4,7 @@
 
 #ifndef GAME_STATE_H
 #define GAME_STATE_H
+#include <memory>
 #include <vector>
 #include "solver/preflop/preflop_action/preflop_action.h"
 
@@ -12,9 +13,17 @@ class PreflopAction;
 struct GameState {
     int player_to_move, max_num_raises, p1_position, p2_position;
     double p1_stack_depth, p2_stack_depth;
+    // total amount each player has put in, blinds included: {p1, p2}
     std::pair<double, double> pot;
+    // size of the largest raise so far, which the next raise must at least match
+    double last_raise = 1;
+    bool terminal = false;
     std::vector<std::shared_ptr<PreflopAction> > history;
 
+    /**
+     * Constructor for GameState. The history is replayed from the blinds, with the players
+     * alternating so that `player_to_move` acts next.
+     */
     GameState(int player_to_move, int p1_position, int p2_position, double p1_stack_depth,
               double p2_stack_depth, std::vector<std::shared_ptr<PreflopAction> > history,
               int max_num_raises);
@@ -29,28 +38,57 @@ struct GameState {
      * Return the total amount each player has contributed to the pot.
      * @return a pair of doubles {p1_contribution, p2_contribution}
      */
-    [[nodiscard]] std::pair<double, double> GetTotalBets();
+    [[nodiscard]] std::pair<double, double> GetTotalBets() const;
 
     /**
-     * Return the amount of the last raise that happened. If the last action wasn't a raise, this
-     * returns 0.
+     * Return the size of the largest raise so far: the big blind before anyone has raised.
      * @return a double representing the amount of the last raise
      */
     [[nodiscard]] double GetLastRaise() const;
 
     /**
      * Return whether the next action can be a raise. This can happen only if the current number of
-     * raises is less than `max_num_raises`.
+     * raises is less than `max_num_raises` and neither player is all-in.
      * @return whether the next player can raise
      */
     [[nodiscard]] bool CanRaise() const;
 
     /**
-     * Return the number of big blinds in `player`'s stack.
+     * Return the number of big blinds left in `player`'s stack.
      * @param player the player whose stack to return
      * @return a double representing the amount of big blinds remaining
      */
     [[nodiscard]] double GetChipsRemaining(int player) const;
+
+    /**
+     * Return the most either player can have in the pot: the smaller starting stack.
+     * @return the effective stack, in big blinds
+     */
+    [[nodiscard]] double GetEffectiveStack() const;
+
+    /**
+     * Return the amount `player` has put in the pot.
+     * @param player the player whose bet to return
+     * @return a double representing the player's contribution
+     */
+    [[nodiscard]] double GetBet(int player) const;
+
+    /**
+     * Return the state before the last action. The history must not be empty.
+     * @return the previous state
+     */
+    [[nodiscard]] GameState GetPreviousGameState() const;
+
+    /**
+     * Return the state after the player to move plays `action`, which must be legal.
+     * @param action the action to play
+     * @return the next state
+     */
+    [[nodiscard]] GameState GetNextGameState(const std::shared_ptr<PreflopAction> &action) const;
+
+private:
+    // Play action for the player to move and pass the turn.
+    void Apply(const std::shared_ptr<PreflopAction> &action);
 };
 
 
@@ -0,0 +1,459 @@
+#include "solver/preflop/infoset_store/infoset_store.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+// Read or add to a value, through std::atomic_ref if ATOMIC is set.
+template<bool ATOMIC, typename T>
+static double Load(const T &value) {
+    if constexpr (ATOMIC)
+        return std::atomic_ref(const_cast<T &>(value)).load(std::memory_order_relaxed);
+    else
+        return value;
+}
+
+template<bool ATOMIC, typename T>
+static void Add(T &value, const double amount) {
+    if constexpr (ATOMIC)
+        std::atomic_ref(value).fetch_add(static_cast<T>(amount), std::memory_order_relaxed);
+    else
+        value += static_cast<T>(amount);
+}
+
+// The values of an array stored as T, read and added to through std::atomic_ref if ATOMIC is set.
+template<typename T, bool ATOMIC>
+struct PlainValues {
+    T *values;
+
+    [[nodiscard]] double Get(const size_t i) const {
+        return Load<ATOMIC>(values[i]);
+    }
+
+    void Add(const size_t i, const double amount) const {
+        ::Add<ATOMIC>(values[i], amount);
+    }
+
+    void ReadRow(const size_t start, const int n, double *out) const {
+        for (int h = 0; h < n; ++h)
+            out[h] = Load<ATOMIC>(values[start + h]);
+    }
+
+    // values[start + h] += weights[h] * amounts[h], or amounts[h] if weights is empty.
+    void AddRow(const size_t start, const int n, const std::span<const double> weights,
+                const double *amounts) const {
+        T *const row = values + start;
+        if (weights.empty())
+            for (int h = 0; h < n; ++h)
+                ::Add<ATOMIC>(row[h], amounts[h]);
+        else
+            for (int h = 0; h < n; ++h)
+                ::Add<ATOMIC>(row[h], weights[h] * amounts[h]);
+    }
+
+    // Multiply positive values by positive and the others by negative; never concurrent.
+    void Scale(const size_t num_values, const double positive, const double negative) const {
+        for (size_t i = 0; i < num_values; ++i)
+            values[i] *= static_cast<T>(values[i] > 0 ? positive : negative);
+    }
+};
+
+// Fixed-point cells: the value is the integer itself.
+template<typename T>
+struct FixedPointCell {
+    using Stored = T;
+    static constexpr double MAX = std::numeric_limits<T>::max();
+
+    static double Decode(const T cell) {
+        return cell;
+    }
+
+    // x rounded down or up, up with probability its fractional part if u is uniform in [0, 1).
+    static T Encode(const double x, const double u) {
+        return static_cast<T>(std::clamp(std::floor(x + u),
+                                         static_cast<double>(std::numeric_limits<T>::min()), MAX));
+    }
+};
+
+// IEEE half floats, stored as their bits. Infinities and NaNs never occur.
+struct HalfCell {
+    using Stored = uint16_t;
+    static constexpr double MAX = 65504;
+
+    static double Decode(const uint16_t bits) {
+        const int exponent = bits >> 10 & 31, mantissa = bits & 1023;
+        const double magnitude = exponent == 0
+                                     ? std::ldexp(mantissa, -24)
+                                     : std::ldexp(1024 + mantissa, exponent - 25);
+        return bits >> 15 ? -magnitude : magnitude;
+    }
+
+    // Rounded down or up in magnitude as in FixedPointCell. Consecutive bit patterns of the
+    // same sign are consecutive halves, so rounding up is adding 1, across exponents too.
+    static uint16_t Encode(const double x, const double u) {
+        const double magnitude = std::min(std::abs(x), MAX);
+        uint16_t bits;
+        if (magnitude < 0x1p-14) {
+            bits = static_cast<uint16_t>(std::floor(std::ldexp(magnitude, 24) + u));
+        } else {
+            int exponent;
+            std::frexp(magnitude, &exponent);
+            // the mantissa with its leading 1, in [1024, 2048)
+            const double steps = std::floor(std::ldexp(magnitude, 11 - exponent) + u);
+            bits = static_cast<uint16_t>(((exponent + 14) << 10) + static_cast<int>(steps) - 1024);
+        }
+        return x < 0 ? bits | 0x8000 : bits;
+    }
+};
+
+// The values of an array stored as Cells, each row of row_size values times its scale.
+template<typename Cell>
+struct QuantizedValues {
+    using T = typename Cell::Stored;
+
+    T *values;
+    float *scales;
+    int row_size;
+    Rng &rng;
+
+    [[nodiscard]] double Get(const size_t i) const {
+        return Cell::Decode(values[i]) * scales[i / row_size];
+    }
+
+    void Add(const size_t i, const double amount) const {
+        const size_t row = i / row_size;
+        Fit(row, std::abs(Get(i) + amount));
+        if (scales[row] == 0)
+            return;
+        values[i] = Cell::Encode(Cell::Decode(values[i]) + amount / scales[row], rng.NextDouble());
+    }
+
+    void ReadRow(const size_t start, const int n, double *out) const {
+        const double scale = scales[start / row_size];
+        for (int h = 0; h < n; ++h)
+            out[h] = Cell::Decode(values[start + h]) * scale;
+    }
+
+    void AddRow(const size_t start, const int n, const std::span<const double> weights,
+                const double *amounts) const {
+        const auto amount = [&](const int h) {
+            return weights.empty() ? amounts[h] : weights[h] * amounts[h];
+        };
+        const size_t row = start / row_size;
+        double largest = 0;
+        for (int h = 0; h < n; ++h)
+            largest = std::max(largest, std::abs(Get(start + h) + amount(h)));
+        Fit(row, largest);
+        // a scale of 0 is left only by a row of zeros that stays so
+        const double scale = scales[row];
+        if (scale == 0)
+            return;
+        for (int h = 0; h < n; ++h)
+            values[start + h] = Cell::Encode(Cell::Decode(values[start + h]) + amount(h) / scale,
+                                             rng.NextDouble());
+    }
+
+    void Scale(const size_t num_values, const double positive, const double negative) const {
+        for (size_t row = 0; row < num_values / row_size; ++row) {
+            // an even factor only changes the scale, and loses nothing
+            if (positive == negative) {
+                scales[row] = static_cast<float>(scales[row] * positive);
+                continue;
+            }
+
+            T *const cells = values + row * row_size;
+            const auto scaled = [&](const int h) {
+                const double value = Cell::Decode(cells[h]) * scales[row];
+                return value * (value > 0 ? positive : negative);
+            };
+            double largest = 0;
+            for (int h = 0; h < row_size; ++h)
+                largest = std::max(largest, std::abs(scaled(h)));
+            if (largest == 0) {
+                std::fill(cells, cells + row_size, T());
+                continue;
+            }
+
+            // refit the row, which may shrink its scale and so regain precision
+            const double scale = GetScale(largest);
+            for (int h = 0; h < row_size; ++h)
+                cells[h] = Cell::Encode(scaled(h) / scale, rng.NextDouble());
+            scales[row] = static_cast<float>(scale);
+        }
+    }
+
+private:
+    // The smallest power of 2 by which values up to largest in magnitude fit in a cell.
+    static double GetScale(const double largest) {
+        return std::exp2(std::ceil(std::log2(largest / Cell::MAX)));
+    }
+
+    // Rescale a row, if needed, so that it can hold values up to largest in magnitude.
+    void Fit(const size_t row, const double largest) const {
+        if (largest <= Cell::MAX * scales[row])
+            return;
+
+        const double scale = GetScale(largest), ratio = scales[row] / scale;
+        T *const cells = values + row * row_size;
+        for (int h = 0; h < row_size; ++h)
+            cells[h] = Cell::Encode(Cell::Decode(cells[h]) * ratio, rng.NextDouble());
+        scales[row] = static_cast<float>(scale);
+    }
+};
+
+// Regret matching or normalization over the rows of one decision: each hand's num_actions values
+// (row_size apart) are clamped at 0 if clamp is set, then normalized, or made uniform if none is
+// positive.
+template<typename Values>
+static void Normalize(const Values &values, const size_t offset, const int num_actions,
+                      const int num_hands, const int row_size, const bool clamp,
+                      double *strategy) {
+    for (int a = 0; a < num_actions; ++a) {
+        double *const row = strategy + a * num_hands;
+        values.ReadRow(offset + static_cast<size_t>(a) * row_size, num_hands, row);
+        if (clamp)
+            for (int h = 0; h < num_hands; ++h)
+                row[h] = std::max(row[h], 0.0);
+    }
+
+    const double uniform = 1.0 / num_actions;
+    for (int h = 0; h < num_hands; ++h) {
+        double norm = 0;
+        for (int a = 0; a < num_actions; ++a)
+            norm += strategy[a * num_hands + h];
+        for (int a = 0; a < num_actions; ++a)
+            strategy[a * num_hands + h] = norm > 0 ? strategy[a * num_hands + h] / norm : uniform;
+    }
+}
+
+// values[a][h] += weights[h] * amounts[a][h], or amounts[a][h] if weights is empty.
+template<typename Values>
+static void Accumulate(const Values &values, const size_t offset, const int num_actions,
+                       const int num_hands, const int row_size,
+                       const std::span<const double> weights, const double *amounts) {
+    for (int a = 0; a < num_actions; ++a)
+        values.AddRow(offset + static_cast<size_t>(a) * row_size, num_hands, weights,
+                      amounts + a * num_hands);
+}
+
+template<typename F>
+void InfosetStore::Visit(const AlignedBuffer &buffer, const Encoding encoding, F &&f) const {
+    // the scales follow the values, which fill whole cache lines
+    const auto quantized = [&]<typename Cell>(Cell) {
+        using T = typename Cell::Stored;
+        f(QuantizedValues<Cell>{Data<T>(buffer),
+                                reinterpret_cast<float *>(buffer.get() + num_values * sizeof(T)),
+                                row_size, rounding});
+    };
+    switch (encoding) {
+        case Encoding::DOUBLE:
+            if (concurrent)
+                f(PlainValues<double, true>{Data<double>(buffer)});
+            else
+                f(PlainValues<double, false>{Data<double>(buffer)});
+            break;
+        case Encoding::FLOAT:
+            if (concurrent)
+                f(PlainValues<float, true>{Data<float>(buffer)});
+            else
+                f(PlainValues<float, false>{Data<float>(buffer)});
+            break;
+        case Encoding::INT32:
+            quantized(FixedPointCell<int32_t>());
+            break;
+        case Encoding::INT16:
+            quantized(FixedPointCell<int16_t>());
+            break;
+        case Encoding::UINT8:
+            quantized(FixedPointCell<uint8_t>());
+            break;
+        case Encoding::HALF:
+            quantized(HalfCell());
+            break;
+    }
+}
+
+InfosetStore::InfosetStore(const std::span<const int> num_actions, const int num_hands,
+                           const Precision precision)
+    : precision(precision), num_hands(num_hands),
+      num_actions(num_actions.begin(), num_actions.end()) {
+    if (num_hands <= 0)
+        throw std::invalid_argument("num_hands must be positive");
+
+    switch (precision) {
+        case Precision::DOUBLE:
+            regret_encoding = strategy_encoding = Encoding::DOUBLE;
+            break;
+        case Precision::FLOAT:
+            regret_encoding = strategy_encoding = Encoding::FLOAT;
+            break;
+        case Precision::FIXED32:
+            regret_encoding = Encoding::INT32;
+            strategy_encoding = Encoding::HALF;
+            break;
+        case Precision::FIXED16:
+            regret_encoding = Encoding::INT16;
+            strategy_encoding = Encoding::UINT8;
+            break;
+        default:
+            throw std::invalid_argument("unknown precision");
+    }
+
+    // pad each row of hands to a whole number of cache lines in both arrays
+    const int values_per_line = static_cast<int>(
+        ALIGNMENT / std::min(GetSize(regret_encoding), GetSize(strategy_encoding)));
+    row_size = (num_hands + values_per_line - 1) / values_per_line * values_per_line;
+
+    size_t offset = 0;
+    offsets.reserve(num_actions.size());
+    for (const int n: num_actions) {
+        if (n <= 0)
+            throw std::invalid_argument("every decision needs an action");
+        offsets.push_back(offset);
+        offset += static_cast<size_t>(n) * row_size;
+    }
+    num_values = offset;
+
+    regrets = Allocate(regret_encoding);
+    strategy_sums = Allocate(strategy_encoding);
+}
+
+size_t InfosetStore::GetSize(const Encoding encoding) {
+    switch (encoding) {
+        case Encoding::DOUBLE:
+            return sizeof(double);
+        case Encoding::FLOAT:
+        case Encoding::INT32:
+            return 4;
+        case Encoding::INT16:
+        case Encoding::HALF:
+            return 2;
+        case Encoding::UINT8:
+            return 1;
+    }
+    return 0;
+}
+
+size_t InfosetStore::GetDataSize(const Encoding encoding) const {
+    const bool quantized = encoding != Encoding::DOUBLE && encoding != Encoding::FLOAT;
+    return num_values * GetSize(encoding) + (quantized ? num_values / row_size * sizeof(float) : 0);
+}
+
+InfosetStore::AlignedBuffer InfosetStore::Allocate(const Encoding encoding) const {
+    // zero scales are fine: a row's scale is set on its first write
+    const size_t bytes = std::max<size_t>(GetDataSize(encoding), 1);
+    AlignedBuffer buffer(static_cast<std::byte *>(
+        ::operator new[](bytes, std::align_val_t(ALIGNMENT))));
+    std::memset(buffer.get(), 0, bytes);
+    return buffer;
+}
+
+void InfosetStore::SetConcurrent(const bool concurrent) {
+    if (concurrent && precision != Precision::DOUBLE && precision != Precision::FLOAT)
+        throw std::invalid_argument("fixed-point stores can't be updated concurrently");
+    this->concurrent = concurrent;
+}
+
+size_t InfosetStore::GetFootprint() const {
+    return GetDataSize(regret_encoding) + GetDataSize(strategy_encoding)
+           + offsets.capacity() * sizeof(size_t) + num_actions.capacity() * sizeof(int)
+           + sizeof(*this);
+}
+
+void InfosetStore::GetStrategy(const int decision, const std::span<double> strategy) const {
+    Visit(regrets, regret_encoding, [&](const auto &values) {
+        Normalize(values, offsets[decision], num_actions[decision], num_hands, row_size, true,
+                  strategy.data());
+    });
+}
+
+void InfosetStore::GetStrategy(const int decision, const int hand,
+                               const std::span<double> strategy) const {
+    Visit(regrets, regret_encoding, [&](const auto &values) {
+        Normalize(values, offsets[decision] + hand, num_actions[decision], 1, row_size, true,
+                  strategy.data());
+    });
+}
+
+void InfosetStore::AddStrategy(const int decision, const std::span<const double> reach,
+                               const std::span<const double> strategy) {
+    Visit(strategy_sums, strategy_encoding, [&](const auto &values) {
+        Accumulate(values, offsets[decision], num_actions[decision], num_hands, row_size, reach,
+                   strategy.data());
+    });
+}
+
+void InfosetStore::AddRegrets(const int decision, const std::span<const double> regrets) {
+    Visit(this->regrets, regret_encoding, [&](const auto &values) {
+        Accumulate(values, offsets[decision], num_actions[decision], num_hands, row_size, {},
+                   regrets.data());
+    });
+}
+
+void InfosetStore::GetAverageStrategy(const int decision, const std::span<double> strategy) const {
+    Visit(strategy_sums, strategy_encoding, [&](const auto &values) {
+        Normalize(values, offsets[decision], num_actions[decision], num_hands, row_size, false,
+                  strategy.data());
+    });
+}
+
+void InfosetStore::Discount(const double positive, const double negative, const double strategy) {
+    // padding stays 0 whatever the factors, so the arrays are scaled whole
+    if (positive != 1 || negative != 1)
+        Visit(regrets, regret_encoding, [&](const auto &values) {
+            values.Scale(num_values, positive, negative);
+        });
+    if (strategy != 1)
+        Visit(strategy_sums, strategy_encoding, [&](const auto &values) {
+            values.Scale(num_values, strategy, strategy);
+        });
+}
+
+std::span<const std::byte> InfosetStore::GetRegretData() const {
+    return {regrets.get(), GetDataSize(regret_encoding)};
+}
+
+std::span<const std::byte> InfosetStore::GetStrategySumData() const {
+    return {strategy_sums.get(), GetDataSize(strategy_encoding)};
+}
+
+void InfosetStore::Load(const std::span<const std::byte> regrets,
+                        const std::span<const std::byte> strategy_sums) {
+    if (regrets.size() != GetDataSize(regret_encoding)
+        || strategy_sums.size() != GetDataSize(strategy_encoding))
+        throw std::invalid_argument("the values don't fit the store");
+    std::memcpy(this->regrets.get(), regrets.data(), regrets.size());
+    std::memcpy(this->strategy_sums.get(), strategy_sums.data(), strategy_sums.size());
+}
+
+double InfosetStore::GetRegret(const int decision, const int hand, const int action) const {
+    double regret = 0;
+    Visit(regrets, regret_encoding, [&](const auto &values) {
+        regret = values.Get(GetIndex(decision, hand, action));
+    });
+    return regret;
+}
+
+void InfosetStore::AddRegret(const int decision, const int hand, const int action,
+                             const double value) {
+    Visit(regrets, regret_encoding, [&](const auto &values) {
+        values.Add(GetIndex(decision, hand, action), value);
+    });
+}
+
+double InfosetStore::GetStrategySum(const int decision, const int hand, const int action) const {
+    double sum = 0;
+    Visit(strategy_sums, strategy_encoding, [&](const auto &values) {
+        sum = values.Get(GetIndex(decision, hand, action));
+    });
+    return sum;
+}
+
+void InfosetStore::AddStrategySum(const int decision, const int hand, const int action,
+                                  const double value) {
+    Visit(strategy_sums, strategy_encoding, [&](const auto &values) {
+        values.Add(GetIndex(decision, hand, action), value);
+    });
+}
@@ -0,0 +1,235 @@
+#ifndef INFOSET_STORE_H
+#define INFOSET_STORE_H
+
+#include "solver/utils/rng.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <vector>
+
+/**
+ * Regrets and strategy sums of every information set of a solver, stored as two large arrays
+ * instead of small vectors per node. An information set is a decision node together with one of
+ * num_hands private hands, and holds one regret and one strategy sum per action.
+ *
+ * The arrays are laid out [decision][action][hand]: for a fixed decision and action the hands are
+ * contiguous, so the vectorized solvers that update every hand at once stream through memory.
+ * Each row of hands is padded to a multiple of 64 bytes and the arrays are 64-byte aligned, so
+ * rows never share a cache line. Values can be stored as doubles or floats; floats halve the
+ * footprint and the precision is ample for regrets. Computations are done in double either way.
+ *
+ * The fixed-point precisions compress further. Each row of hands then has a scale, a power of 2,
+ * and its values are stored as small integers or half floats times that scale. A row is rescaled
+ * when an update would overflow it, and whenever a discount changes its values unevenly. Writes
+ * round stochastically, so that updates smaller than a step are kept on average rather than
+ * always lost.
+ *
+ * In concurrent mode several threads may update the store at once without locks: every value is
+ * read and added to through std::atomic_ref with relaxed ordering, so no update is lost, though
+ * a thread may see another's updates late. CFR tolerates that staleness.
+ */
+class InfosetStore {
+public:
+    enum class Precision : uint8_t {
+        DOUBLE,
+        FLOAT,
+        // 32-bit fixed-point regrets and half-float strategy sums
+        FIXED32,
+        // 16-bit fixed-point regrets and 8-bit strategy sums
+        FIXED16
+    };
+
+    static constexpr size_t ALIGNMENT = 64;
+
+private:
+    struct AlignedDelete {
+        void operator()(std::byte *data) const {
+            ::operator delete[](data, std::align_val_t(ALIGNMENT));
+        }
+    };
+    using AlignedBuffer = std::unique_ptr<std::byte[], AlignedDelete>;
+
+    // how the values of one array are stored
+    enum class Encoding : uint8_t {
+        DOUBLE,
+        FLOAT,
+        INT32,
+        INT16,
+        UINT8,
+        HALF
+    };
+
+    Precision precision;
+    Encoding regret_encoding, strategy_encoding;
+    int num_hands, row_size;
+    // offsets[d] is the index of decision d's first value; decision d has num_actions[d] rows
+    std::vector<size_t> offsets;
+    std::vector<int> num_actions;
+    size_t num_values;
+    AlignedBuffer regrets, strategy_sums;
+    bool concurrent = false;
+    // draws for stochastic rounding; the fixed-point precisions are never concurrent
+    mutable Rng rounding{0};
+
+    // Allocate and zero an array: num_values values, followed by a float scale per row if the
+    // encoding is fixed-point.
+    [[nodiscard]] AlignedBuffer Allocate(Encoding encoding) const;
+
+    // The size of a value stored as encoding.
+    static size_t GetSize(Encoding encoding);
+
+    // The size of an array, in bytes.
+    [[nodiscard]] size_t GetDataSize(Encoding encoding) const;
+
+    template<typename T>
+    [[nodiscard]] T *Data(const AlignedBuffer &buffer) const;
+
+    // Call f(values) with an accessor for the values of buffer, stored as encoding: a type with
+    // Get, Add, ReadRow, AddRow and Scale that hides the encoding and whether values must be
+    // accessed atomically.
+    template<typename F>
+    void Visit(const AlignedBuffer &buffer, Encoding encoding, F &&f) const;
+
+public:
+    /**
+     * Constructor for InfosetStore. Every regret and strategy sum starts at 0.
+     * @param num_actions the number of actions at each decision node
+     * @param num_hands the number of private hands, e.g. 169 hand classes
+     * @param precision the type the values are stored as
+     */
+    InfosetStore(std::span<const int> num_actions, int num_hands,
+                 Precision precision = Precision::DOUBLE);
+
+    [[nodiscard]] int GetNumDecisions() const;
+
+    [[nodiscard]] int GetNumHands() const;
+
+    [[nodiscard]] int GetNumActions(int decision) const;
+
+    [[nodiscard]] Precision GetPrecision() const;
+
+    /**
+     * Sets whether several threads may read and update the store at the same time.
+     * @param concurrent whether to access the values atomically; throws std::invalid_argument
+     *                   for the fixed-point precisions, which rescale rows in place
+     */
+    void SetConcurrent(bool concurrent);
+
+    /**
+     * Returns the memory held by the store.
+     * @return the size of the value arrays and the index, in bytes
+     */
+    [[nodiscard]] size_t GetFootprint() const;
+
+    /**
+     * Sets the current strategy of every hand at a decision by regret matching: each action is
+     * played in proportion to its positive regret, or uniformly if no regret is positive.
+     * @param decision the decision node
+     * @param strategy set to num_actions * num_hands probabilities, laid out [action][hand]
+     */
+    void GetStrategy(int decision, std::span<double> strategy) const;
+
+    /**
+     * Sets the current strategy of a single hand at a decision, as above.
+     * @param decision the decision node
+     * @param hand the hand
+     * @param strategy set to num_actions probabilities
+     */
+    void GetStrategy(int decision, int hand, std::span<double> strategy) const;
+
+    /**
+     * Adds a strategy to the strategy sums of every hand at a decision.
+     * @param decision the decision node
+     * @param reach the weight of each hand, e.g. its probability of reaching the node
+     * @param strategy the strategy, laid out as in GetStrategy
+     */
+    void AddStrategy(int decision, std::span<const double> reach,
+                     std::span<const double> strategy);
+
+    /**
+     * Adds to the regrets of every hand at a decision.
+     * @param decision the decision node
+     * @param regrets the amounts to add, laid out as in GetStrategy
+     */
+    void AddRegrets(int decision, std::span<const double> regrets);
+
+    /**
+     * Sets the average strategy of every hand at a decision: the strategy sums, normalized, or
+     * uniform where they are all 0.
+     * @param decision the decision node
+     * @param strategy set to the strategy, laid out as in GetStrategy
+     */
+    void GetAverageStrategy(int decision, std::span<double> strategy) const;
+
+    /**
+     * Scales every value, as discounting update rules do between iterations. Must not run while
+     * other threads update the store.
+     * @param positive the factor for positive regrets
+     * @param negative the factor for negative regrets
+     * @param strategy the factor for strategy sums
+     */
+    void Discount(double positive, double negative, double strategy);
+
+    /**
+     * Returns the regrets as raw bytes, padding and scales included, e.g. to save them. Must not
+     * be read while other threads update the store.
+     * @return the array of regrets
+     */
+    [[nodiscard]] std::span<const std::byte> GetRegretData() const;
+
+    /**
+     * Returns the strategy sums as raw bytes, as above.
+     * @return the array of strategy sums
+     */
+    [[nodiscard]] std::span<const std::byte> GetStrategySumData() const;
+
+    /**
+     * Replaces every value with ones saved from a store of the same shape and precision.
+     * @param regrets the regrets, as returned by GetRegretData
+     * @param strategy_sums the strategy sums, as returned by GetStrategySumData; throws
+     *                      std::invalid_argument if either size doesn't match
+     */
+    void Load(std::span<const std::byte> regrets, std::span<const std::byte> strategy_sums);
+
+    // Access to single values.
+    [[nodiscard]] double GetRegret(int decision, int hand, int action) const;
+
+    void AddRegret(int decision, int hand, int action, double value);
+
+    [[nodiscard]] double GetStrategySum(int decision, int hand, int action) const;
+
+    void AddStrategySum(int decision, int hand, int action, double value);
+
+private:
+    // The index of a value.
+    [[nodiscard]] size_t GetIndex(int decision, int hand, int action) const;
+};
+
+inline int InfosetStore::GetNumDecisions() const {
+    return static_cast<int>(num_actions.size());
+}
+
+inline int InfosetStore::GetNumHands() const {
+    return num_hands;
+}
+
+inline int InfosetStore::GetNumActions(const int decision) const {
+    return num_actions[decision];
+}
+
+inline InfosetStore::Precision InfosetStore::GetPrecision() const {
+    return precision;
+}
+
+inline size_t InfosetStore::GetIndex(const int decision, const int hand, const int action) const {
+    return offsets[decision] + static_cast<size_t>(action) * row_size + hand;
+}
+
+template<typename T>
+T *InfosetStore::Data(const AlignedBuffer &buffer) const {
+    return std::launder(reinterpret_cast<T *>(buffer.get()));
+}
+
+#endif //INFOSET_STORE_H
@@ -1,19 +1,27 @@
 #ifndef NODE_H
 #define NODE_H
 
-#include "solver/eval/eval.h"
-#include "solver/preflop/preflop_solver.h"
+#include "solver/preflop/game_state/game_state.h"
+#include "solver/preflop/infoset_store/infoset_store.h"
+#include "solver/preflop/preflop_action/preflop_action.h"
+#include <memory>
+#include <vector>
 
-// Node in NLHE
+// Node in NLHE. Its regrets and strategy sums live in an InfosetStore, as one of the store's
+// information sets: a Node is a view of them. A Node built without a store owns a store of its
+// own with a single information set.
 class Node {
     std::shared_ptr<GameState> state;
-    std::vector<double> strategy, strategy_sum, regret_sum;
 
     double p1_bet, p2_bet, p1_equity_multiplier;
 
     // Actions available in this state
     std::vector<std::shared_ptr<PreflopAction> > actions;
 
+    std::unique_ptr<InfosetStore> owned_store;
+    InfosetStore *store = nullptr;
+    int decision = 0, hand = 0;
+
     /**
      * Given a history of actions, return the actions that can be taken in this state
      * @return array of legal actions that can be played at this node
@@ -25,9 +33,19 @@ public:
     Node(std::shared_ptr<GameState> state, double p1_equity_multiplier,
          const std::vector<std::shared_ptr<PreflopAction> >& action_space);
 
-    // If this node is terminal, return utility of
-    // this node to second-to-last player to act
-    [[nodiscard]] double GetUtility(const std::vector<u32> &deck) const;
+    // Node holding only the regrets and strategies of num_actions actions, for trees such as
+    // PreflopTree that keep the game state and evaluate terminals themselves. GetUtility and
+    // GetLegalActions must not be used on it.
+    explicit Node(int num_actions);
+
+    // View of the information set of `hand` at `decision` in store, which must outlive it.
+    // GetUtility and GetLegalActions must not be used on it.
+    Node(InfosetStore &store, int decision, int hand);
+
+    // If this node is terminal, return expected utility of
+    // this node to second-to-last player to act, given player 1's
+    // all-in equity against player 2 (e.g. from a PreflopEquityTable)
+    [[nodiscard]] double GetUtility(double p1_equity) const;
 
     // Update strategy using regret matching, using p as the reach probability
     // of being in this state
@@ -38,6 +56,9 @@ public:
 
     // Return computed strategy at this node
     [[nodiscard]] std::vector<double> GetAverageStrategy() const;
+
+    // Return the legal actions at this node, in the order of the action space
+    [[nodiscard]] const std::vector<std::shared_ptr<PreflopAction> >& GetLegalActions() const;
 };
 
 #endif
@@ -4,6 +4,7 @@
 
 #include "preflop_action.h"
 #include "../../utils/utils.h"
+#include <algorithm>
 
 PreflopAction::PreflopAction() = default;
 Fold::Fold() = default;
@@ -34,7 +35,7 @@ std::shared_ptr<PreflopAction> PreflopAction::AllIn() {
 }
 
 // PreflopAction::Fold methods
-bool Fold::IsLegal(GameState state) {
+bool Fold::IsLegal(const GameState &state) {
     if (state.IsTerminal())
         return false;
 
@@ -45,7 +46,7 @@ bool Fold::IsLegal(GameState state) {
     return state.player_to_move == 1 ? p2_bet > p1_bet : p1_bet > p2_bet;
 }
 
-double Fold::GetBetAmount(GameState state) {
+double Fold::GetBetAmount(const GameState &state) {
     // folding does not require any bet
     return 0.0;
 }
@@ -54,13 +55,13 @@ std::size_t Fold::Hash() const {
     return 1;
 }
 
-bool Fold::IsTerminal(GameState state) const {
+bool Fold::IsTerminal(const GameState &state) const {
     // folding is always terminal
     return true;
 }
 
 // PreflopAction::Check methods
-bool Check::IsLegal(GameState state) {
+bool Check::IsLegal(const GameState &state) {
     if (state.IsTerminal())
         return false;
 
@@ -69,7 +70,7 @@ bool Check::IsLegal(GameState state) {
     return p1_bet == p2_bet;
 }
 
-double Check::GetBetAmount(GameState state) {
+double Check::GetBetAmount(const GameState &state) {
     return 0.0;
 }
 
@@ -77,50 +78,53 @@ std::size_t Check::Hash() const {
     return 2;
 }
 
-bool Check::IsTerminal(GameState state) const {
-    // a check always closes action preflop heads-up
-    return true;
+bool Check::IsTerminal(const GameState &state) const {
+    // a check closes action preflop heads-up, unless it's the first action
+    return !state.history.empty();
 }
 
 // PreflopAction::Call methods
-bool Call::IsLegal(GameState state) {
+bool Call::IsLegal(const GameState &state) {
     if (state.IsTerminal())
         return false;
 
     auto [p1_bet, p2_bet] = state.GetTotalBets();
-    // call is legal only if there is an outstanding bet
-    return p1_bet != p2_bet;
+    // call is legal only if the other player has made a higher bet
+    return state.player_to_move == 1 ? p2_bet > p1_bet : p1_bet > p2_bet;
 }
 
-double Call::GetBetAmount(GameState state) {
+double Call::GetBetAmount(const GameState &state) {
     const auto [p1_bet, p2_bet] = state.GetTotalBets();
-    // call amount is always outstanding bet amount
-    return abs(p1_bet - p2_bet);
+    // call amount is the outstanding bet amount, or whatever is left of the stack
+    return std::min(std::abs(p1_bet - p2_bet), state.GetChipsRemaining(state.player_to_move));
 }
 
 std::size_t Call::Hash() const {
     return 3;
 }
 
-bool Call::IsTerminal(const GameState state) const {
+bool Call::IsTerminal(const GameState &state) const {
     // a call always closes action preflop heads-up unless it's p1 limping
     return !state.history.empty();
 }
 
 // PreflopAction::Bet methods
-bool Bet::IsLegal(GameState state) {
+bool Bet::IsLegal(const GameState &state) {
     if (state.IsTerminal() || !state.CanRaise())
         return false;
 
-    const double chips_remaining = state.GetChipsRemaining(state.player_to_move);
-    const double last_raise = state.GetLastRaise();
-    const double bet_amount = GetBetAmount(state);
+    // a bet opens the action, so there must be nothing to call
+    const auto [p1_bet, p2_bet] = state.GetTotalBets();
+    if (p1_bet != p2_bet)
+        return false;
 
-    return bet_amount >= 2.0 * last_raise // must raise at least 2x
-           && bet_amount <= chips_remaining; // must have the chips
+    const double bet_amount = GetBetAmount(state);
+    return bet_amount >= state.GetLastRaise() // must bet at least the last raise
+           // must leave chips behind, otherwise AllIn should be used
+           && state.GetBet(state.player_to_move) + bet_amount < state.GetEffectiveStack();
 }
 
-double Bet::GetBetAmount(GameState state) {
+double Bet::GetBetAmount(const GameState &state) {
     // calculate the current pot
     auto [p1_bet, p2_bet] = state.GetTotalBets();
 
@@ -134,40 +138,33 @@ std::size_t Bet::Hash() const {
     return seed;
 }
 
-bool Bet::IsTerminal(GameState state) const {
+bool Bet::IsTerminal(const GameState &state) const {
     // betting a proportion of the pot never closes action
     return false;
 }
 
 // PreflopAction::Raise methods
-bool Raise::IsLegal(GameState state) {
+bool Raise::IsLegal(const GameState &state) {
     if (state.IsTerminal() || !state.CanRaise())
         return false;
 
-    const double chips_remaining_1 = state.GetChipsRemaining(1);
-    const double chips_remaining_2 = state.GetChipsRemaining(2);
-    const double last_raise = state.GetLastRaise();
+    const auto [p1_bet, p2_bet] = state.GetTotalBets();
+    const double max_bet = std::max(p1_bet, p2_bet);
+    const double raise_to = max_bet * bet_multiplier;
 
-    // this is a legal action if there was a previous bet,
-    // and if the raise doesn't put either player all-in (if this is the case, AllIn should be used)
-    return last_raise > 0
-           && std::min(chips_remaining_1, chips_remaining_2) > bet_multiplier * last_raise;
+    // this is a legal action if there was a previous bet, if it raises by at least the last raise,
+    // and if it doesn't put either player all-in (if this is the case, AllIn should be used)
+    return max_bet > 0
+           && raise_to - max_bet >= state.GetLastRaise()
+           && raise_to < state.GetEffectiveStack();
 }
 
-double Raise::GetBetAmount(GameState state) {
-    const double last_raise = state.GetPreviousGameState().GetLastRaise();
-
-    // if it's small blind open, they already have 0.5bb in
-    if ((state.player_to_move == 1 && state.p1_position == 0)
-        || (state.player_to_move == 2 && state.p2_position == 0))
-        return last_raise * bet_multiplier - 0.5;
-    // if it's big blind open, they already have 1bb in
-    if ((state.player_to_move == 1 && state.p1_position == 1)
-        || (state.player_to_move == 2 && state.p2_position == 1))
-        return last_raise * bet_multiplier - 1;
+double Raise::GetBetAmount(const GameState &state) {
+    const auto [p1_bet, p2_bet] = state.GetTotalBets();
 
-    // raise is a multiple of the last raise amount
-    return last_raise * bet_multiplier;
+    // raise to a multiple of the largest bet, counting what this player already has in (e.g. the
+    // small blind's 0.5bb)
+    return std::max(p1_bet, p2_bet) * bet_multiplier - state.GetBet(state.player_to_move);
 }
 
 std::size_t Raise::Hash() const {
@@ -176,32 +173,29 @@ std::size_t Raise::Hash() const {
     return seed;
 }
 
-bool Raise::IsTerminal(const GameState state) const {
+bool Raise::IsTerminal(const GameState &state) const {
     // a raise always re-opens action
     return false;
 }
 
 // PreflopAction::AllIn methods
-bool AllIn::IsLegal(GameState state) {
+bool AllIn::IsLegal(const GameState &state) {
     if (state.IsTerminal() || !state.CanRaise())
         return false;
 
-    const double chips_remaining = state.GetChipsRemaining(state.player_to_move);
-    return chips_remaining > 0;
+    return state.GetBet(state.player_to_move) < state.GetEffectiveStack();
 }
 
-double AllIn::GetBetAmount(GameState state) {
-    const double chips_remaining_1 = state.GetChipsRemaining(1);
-    const double chips_remaining_2 = state.GetChipsRemaining(2);
-    // all in always is just the effective stack
-    return std::min(chips_remaining_1, chips_remaining_2);
+double AllIn::GetBetAmount(const GameState &state) {
+    // all in always is just the effective stack, less what this player already has in
+    return state.GetEffectiveStack() - state.GetBet(state.player_to_move);
 }
 
 std::size_t AllIn::Hash() const {
     return 6;
 }
 
-bool AllIn::IsTerminal(GameState state) const {
+bool AllIn::IsTerminal(const GameState &state) const {
     // all-in bet is never terminal (calling an all-in bet would be a Call)
     return false;
 }
@@ -5,6 +5,7 @@
 #ifndef PREFLOP_ACTION_H
 #define PREFLOP_ACTION_H
 
+#include <memory>
 #include <vector>
 
 #include "solver/preflop/game_state/game_state.h"
@@ -23,7 +24,7 @@ public:
 	 * @param state the current state of the game (not including this action)
 	 * @return whether this action is a legal move
 	 */
-	[[nodiscard]] virtual bool IsLegal(GameState state) = 0;
+	[[nodiscard]] virtual bool IsLegal(const GameState &state) = 0;
 
 	/**
 	 * Given a valid history of PreflopActions, return the value of this bet, in big blinds. In
@@ -33,7 +34,7 @@ public:
 	 * @param state the current state of the game (not including this action)
 	 * @return the increase in value that this move induces
 	 */
-	[[nodiscard]] virtual double GetBetAmount(GameState state) = 0;
+	[[nodiscard]] virtual double GetBetAmount(const GameState &state) = 0;
 
 	/**
 	 * Returns a hash of this action.
@@ -46,7 +47,7 @@ public:
 	 * @param state the current state of the game (not including this action)
 	 * @return whether this action is terminal
 	 */
-	[[nodiscard]] virtual bool IsTerminal(GameState state) const = 0;
+	[[nodiscard]] virtual bool IsTerminal(const GameState &state) const = 0;
 
 	// Static Factory methods
 	static std::shared_ptr<PreflopAction> Fold();
@@ -61,39 +62,39 @@ class Fold final : public PreflopAction {
 public:
 	explicit Fold();
 
-	[[nodiscard]] bool IsLegal(GameState state) override;
+	[[nodiscard]] bool IsLegal(const GameState &state) override;
 
-	[[nodiscard]] double GetBetAmount(GameState state) override;
+	[[nodiscard]] double GetBetAmount(const GameState &state) override;
 
 	[[nodiscard]] std::size_t Hash() const override;
 
-	[[nodiscard]] bool IsTerminal(GameState state) const override;
+	[[nodiscard]] bool IsTerminal(const GameState &state) const override;
 };
 
 class Check final : public PreflopAction {
 public:
 	explicit Check();
 
-	[[nodiscard]] bool IsLegal(GameState state) override;
+	[[nodiscard]] bool IsLegal(const GameState &state) override;
 
-	[[nodiscard]] double GetBetAmount(GameState state) override;
+	[[nodiscard]] double GetBetAmount(const GameState &state) override;
 
 	[[nodiscard]] std::size_t Hash() const override;
 
-	[[nodiscard]] bool IsTerminal(GameState state) const override;
+	[[nodiscard]] bool IsTerminal(const GameState &state) const override;
 };
 
 class Call final : public PreflopAction {
 public:
 	explicit Call();
 
-	[[nodiscard]] bool IsLegal(GameState state) override;
+	[[nodiscard]] bool IsLegal(const GameState &state) override;
 
-	[[nodiscard]] double GetBetAmount(GameState state) override;
+	[[nodiscard]] double GetBetAmount(const GameState &state) override;
 
 	[[nodiscard]] std::size_t Hash() const override;
 
-	[[nodiscard]] bool IsTerminal(GameState state) const override;
+	[[nodiscard]] bool IsTerminal(const GameState &state) const override;
 };
 
 class Bet final : public PreflopAction {
@@ -101,13 +102,13 @@ class Bet final : public PreflopAction {
 public:
 	explicit Bet(double pot_multiplier);
 
-	[[nodiscard]] bool IsLegal(GameState state) override;
+	[[nodiscard]] bool IsLegal(const GameState &state) override;
 
-	[[nodiscard]] double GetBetAmount(GameState state) override;
+	[[nodiscard]] double GetBetAmount(const GameState &state) override;
 
 	[[nodiscard]] std::size_t Hash() const override;
 
-	[[nodiscard]] bool IsTerminal(GameState state) const override;
+	[[nodiscard]] bool IsTerminal(const GameState &state) const override;
 };
 
 class Raise final : public PreflopAction {
@@ -115,26 +116,26 @@ class Raise final : public PreflopAction {
 public:
 	explicit Raise(double bet_multiplier);
 
-	[[nodiscard]] bool IsLegal(GameState state) override;
+	[[nodiscard]] bool IsLegal(const GameState &state) override;
 
-	[[nodiscard]] double GetBetAmount(GameState state) override;
+	[[nodiscard]] double GetBetAmount(const GameState &state) override;
 
 	[[nodiscard]] std::size_t Hash() const override;
 
-	[[nodiscard]] bool IsTerminal(GameState state) const override;
+	[[nodiscard]] bool IsTerminal(const GameState &state) const override;
 };
 
 class AllIn final : public PreflopAction {
 public:
 	explicit AllIn();
 
-	[[nodiscard]] bool IsLegal(GameState state) override;
+	[[nodiscard]] bool IsLegal(const GameState &state) override;
 
-	[[nodiscard]] double GetBetAmount(GameState state) override;
+	[[nodiscard]] double GetBetAmount(const GameState &state) override;
 
 	[[nodiscard]] std::size_t Hash() const override;
 
-	[[nodiscard]] bool IsTerminal(GameState state) const override;
+	[[nodiscard]] bool IsTerminal(const GameState &state) const override;
 };
 
 #endif //PREFLOP_ACTION_H
@@ -3,3 +3,1079 @@
 //
 
 #include "preflop_solver.h"
+#include "solver/equity/preflop_equity.h"
+#include "solver/eval/incremental_eval.h"
+#include "solver/utils/dealer.h"
+#include "solver/utils/rng.h"
+#include "solver/utils/utils.h"
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+static constexpr int NUM_HANDS = Utils::NUM_HAND_CLASSES;
+
+// Showdowns sampled per pair of hand classes when estimating their equity.
+static constexpr int EQUITY_SAMPLES = 1000;
+
+// Hand class against hand class, with card removal. weights[169 * h + o] is the number of pairs
+// of disjoint combos from classes h and o, and equities[169 * h + o] the sum of h's all-in equity
+// over those pairs, so dividing the two gives h's equity against o. totals[h] sums h's row of
+// weights: the number of deals in which a player holds h.
+struct ClassMatchups {
+    std::vector<double> weights, equities, totals;
+};
+
+// The cards of each combo of each hand class.
+static std::vector<std::vector<std::pair<int, int> > > GetClassCombos() {
+    std::vector<std::vector<std::pair<int, int> > > combos(NUM_HANDS);
+    for (int combo = 0; combo < Utils::NUM_COMBOS; ++combo)
+        combos[Utils::ComboToHandClass(combo)].push_back(Utils::ComboToIndices(combo));
+    return combos;
+}
+
+// The weights and totals of every matchup, with the equities left at 0.
+static ClassMatchups InitClassWeights() {
+    ClassMatchups matchups{std::vector<double>(NUM_HANDS * NUM_HANDS),
+                           std::vector<double>(NUM_HANDS * NUM_HANDS),
+                           std::vector<double>(NUM_HANDS)};
+
+    const auto combos = GetClassCombos();
+
+    for (int h = 0; h < NUM_HANDS; ++h)
+        for (int o = 0; o < NUM_HANDS; ++o)
+            for (const auto &[h1, h2]: combos[h])
+                for (const auto &[o1, o2]: combos[o])
+                    matchups.weights[NUM_HANDS * h + o] += h1 != o1 && h1 != o2 && h2 != o1
+                            && h2 != o2;
+    for (int h = 0; h < NUM_HANDS; ++h)
+        for (int o = 0; o < NUM_HANDS; ++o)
+            matchups.totals[h] += matchups.weights[NUM_HANDS * h + o];
+    return matchups;
+}
+
+// The matchups with equities estimated by sampling boards.
+static ClassMatchups EstimateClassMatchups() {
+    ClassMatchups matchups = InitClassWeights();
+    const auto combos = GetClassCombos();
+
+    // estimate each equity from random disjoint combos and boards; a class against itself is
+    // even by symmetry
+    const IncrementalEval eval;
+    Dealer dealer;
+    Rng rng(0);
+    for (int h = 0; h < NUM_HANDS; ++h) {
+        matchups.equities[NUM_HANDS * h + h] = 0.5 * matchups.weights[NUM_HANDS * h + h];
+
+        for (int o = h + 1; o < NUM_HANDS; ++o) {
+            double wins = 0;
+            for (int s = 0; s < EQUITY_SAMPLES; ++s) {
+                std::pair<int, int> hand, opponent;
+                u64 dead;
+                do {
+                    hand = combos[h][rng.Below(combos[h].size())];
+                    opponent = combos[o][rng.Below(combos[o].size())];
+                    dead = 1ULL << hand.first | 1ULL << hand.second;
+                } while (dead >> opponent.first & 1 || dead >> opponent.second & 1);
+                dead |= 1ULL << opponent.first | 1ULL << opponent.second;
+
+                IncrementalEval::State board;
+                for (u64 dealt = dealer.Deal(rng, 5, dead); dealt; dealt &= dealt - 1)
+                    board = eval.Add(board, Utils::IndexToCard(std::countr_zero(dealt)));
+
+                const int rank = eval.GetRank(eval.Add(eval.Add(board,
+                                                                Utils::IndexToCard(hand.first)),
+                                                       Utils::IndexToCard(hand.second)));
+                const int opponent_rank = eval.GetRank(
+                    eval.Add(eval.Add(board, Utils::IndexToCard(opponent.first)),
+                             Utils::IndexToCard(opponent.second)));
+                wins += rank < opponent_rank ? 1 : rank == opponent_rank ? 0.5 : 0;
+            }
+
+            const double equity = wins / EQUITY_SAMPLES;
+            matchups.equities[NUM_HANDS * h + o] = equity * matchups.weights[NUM_HANDS * h + o];
+            matchups.equities[NUM_HANDS * o + h] =
+                    (1 - equity) * matchups.weights[NUM_HANDS * o + h];
+        }
+    }
+
+    return matchups;
+}
+
+// The matchups with exact equities, read from a table.
+static ClassMatchups InitClassMatchups(const PreflopEquityTable &table) {
+    ClassMatchups matchups = InitClassWeights();
+    for (int h = 0; h < NUM_HANDS; ++h)
+        for (int o = 0; o < NUM_HANDS; ++o)
+            matchups.equities[NUM_HANDS * h + o] =
+                    table.GetEquity(h, o) * matchups.weights[NUM_HANDS * h + o];
+    return matchups;
+}
+
+// The matchups of a solver: estimated once for every solver of the process that asks for it, or
+// else read from the table at path, or if it's empty from the one the build points at.
+static std::shared_ptr<const ClassMatchups> GetClassMatchups(const std::string &path,
+                                                             const bool estimate) {
+    if (estimate) {
+        static const auto estimated = std::make_shared<const ClassMatchups>(
+            EstimateClassMatchups());
+        return estimated;
+    }
+    return std::make_shared<const ClassMatchups>(InitClassMatchups(
+        PreflopEquityTable::Load(path.empty() ? PREFLOP_EQUITY_TABLE : path)));
+}
+
+// Preflop, the blinds act last: the small blind, then the big blind.
+static int GetActingOrder(const int position) {
+    return position < 2 ? position + 1000 : position;
+}
+
+// The state before the first action.
+static GameState MakeRoot(const double p1_stack_depth, const double p2_stack_depth,
+                          const int p1_position, const int p2_position, const int num_max_raises) {
+    if (p1_position == p2_position)
+        throw std::invalid_argument("players must be in different positions");
+
+    const int first_player = GetActingOrder(p1_position) < GetActingOrder(p2_position) ? 1 : 2;
+    return {first_player, p1_position, p2_position, p1_stack_depth, p2_stack_depth, {},
+            num_max_raises};
+}
+
+// The number of actions at each decision of tree.
+static std::vector<int> GetNumActions(const PreflopTree &tree) {
+    std::vector<int> num_actions;
+    for (int node = 0; node < tree.GetNumNodes(); ++node)
+        if (tree.GetNode(node).type == PreflopTree::NodeType::DECISION)
+            num_actions.push_back(tree.GetNode(node).num_children);
+    return num_actions;
+}
+
+// The shape of a tree, as a checkpoint records it.
+static void GetCheckpointTree(const PreflopTree &tree, std::vector<Checkpoint::Node> &nodes,
+                              std::vector<Checkpoint::ActionKind> &actions) {
+    for (int n = 0; n < tree.GetNumNodes(); ++n) {
+        const PreflopTree::TreeNode &node = tree.GetNode(n);
+        nodes.push_back({node.p1_bet, node.p2_bet, node.player, static_cast<uint8_t>(node.type),
+                         node.all_in, static_cast<uint16_t>(node.num_children)});
+        for (int a = 0; a < node.num_children; ++a)
+            actions.push_back(Checkpoint::GetActionKind(*tree.GetAction(n, a)));
+    }
+}
+
+// A betting tree as a checkpoint records it, indexed for walking.
+struct CheckpointTree {
+    std::span<const Checkpoint::Node> nodes;
+    std::span<const Checkpoint::ActionKind> actions;
+    // edges[first_edge[n] + a] is the a-th edge of node n, and children the node it leads to
+    std::vector<int> first_edge, children, decisions;
+
+    CheckpointTree(const std::span<const Checkpoint::Node> nodes,
+                   const std::span<const Checkpoint::ActionKind> actions)
+        : nodes(nodes), actions(actions), first_edge(nodes.size()), children(actions.size()),
+          decisions(nodes.size(), -1) {
+        int num_edges = 0, num_decisions = 0;
+        for (size_t n = 0; n < nodes.size(); ++n) {
+            first_edge[n] = num_edges;
+            num_edges += nodes[n].num_children;
+            if (static_cast<PreflopTree::NodeType>(nodes[n].type)
+                == PreflopTree::NodeType::DECISION)
+                decisions[n] = num_decisions++;
+        }
+        if (!nodes.empty() && Index(0) != static_cast<int>(nodes.size()))
+            throw std::runtime_error("malformed tree");
+    }
+
+    // Set the children of the nodes in the subtree rooted at n and return the index past it.
+    int Index(const int n) {
+        int next = n + 1;
+        for (int a = 0; a < nodes[n].num_children; ++a) {
+            if (next >= static_cast<int>(nodes.size()))
+                throw std::runtime_error("malformed tree");
+            children[first_edge[n] + a] = next;
+            next = Index(next);
+        }
+        return next;
+    }
+
+    [[nodiscard]] std::vector<int> GetNumActions() const {
+        std::vector<int> num_actions;
+        for (size_t n = 0; n < nodes.size(); ++n)
+            if (decisions[n] >= 0)
+                num_actions.push_back(nodes[n].num_children);
+        return num_actions;
+    }
+};
+
+// The chips a player has put in at a node.
+static double GetBet(const Checkpoint::Node &node, const int player) {
+    return player == 1 ? node.p1_bet : node.p2_bet;
+}
+
+PreflopSolver::PreflopSolver(const double p1_starting_stack_depth,
+                             const double p2_starting_stack_depth, const int p1_position,
+                             const int p2_position, const int num_max_raises,
+                             const double p1_equity_multiplier,
+                             std::vector<std::shared_ptr<PreflopAction> > p1_action_space,
+                             std::vector<std::shared_ptr<PreflopAction> > p2_action_space,
+                             const SolverOptions &options)
+    : p1_starting_stack_depth(p1_starting_stack_depth),
+      p2_starting_stack_depth(p2_starting_stack_depth), p1_position(p1_position),
+      p2_position(p2_position), num_max_raises(num_max_raises),
+      p1_equity_multiplier(p1_equity_multiplier), p1_action_space(std::move(p1_action_space)),
+      p2_action_space(std::move(p2_action_space)),
+      tree(MakeRoot(p1_starting_stack_depth, p2_starting_stack_depth, p1_position, p2_position,
+                    num_max_raises), this->p1_action_space, this->p2_action_space),
+      store(GetNumActions(tree), NUM_HANDS, options.precision),
+      scheduler(options.num_threads), split_threshold(options.split_threshold),
+      mode(options.mode), exploration(options.exploration), seed(options.seed),
+      rule(options.rule), discount_interval(options.discount_interval),
+      prune_threshold(options.prune_threshold), prune_iterations(options.prune_iterations),
+      prune_countdowns(std::max(tree.GetNumNodes() - 1, 0)),
+      checkpoint_interval(options.checkpoint_interval),
+      class_matchups(GetClassMatchups(options.equity_table, options.estimate_equities)),
+      walk_counts(scheduler.GetNumThreads()), terminal_counts(tree.GetNumNodes() + 1),
+      telemetry_interval(options.telemetry_interval),
+      telemetry_exploitability(options.telemetry_exploitability),
+      telemetry_callback(options.telemetry_callback) {
+    if (exploration <= 0 || exploration > 1)
+        throw std::invalid_argument("exploration must be in (0, 1]");
+    if (discount_interval <= 0)
+        throw std::invalid_argument("discount_interval must be positive");
+    if (checkpoint_interval < 0)
+        throw std::invalid_argument("checkpoint_interval must not be negative");
+    if (checkpoint_interval > 0) {
+        if (options.checkpoint_path.empty())
+            throw std::invalid_argument("checkpoint_interval is set without a checkpoint_path");
+        checkpoint_writer = std::make_unique<CheckpointWriter>(options.checkpoint_path);
+    }
+    if (telemetry_interval < 0)
+        throw std::invalid_argument("telemetry_interval must not be negative");
+    if (telemetry_interval > 0) {
+        if (options.telemetry_path.empty() && !telemetry_callback)
+            throw std::invalid_argument(
+                "telemetry_interval is set without a telemetry_path or telemetry_callback");
+        if (!options.telemetry_path.empty())
+            telemetry_log = std::make_unique<TelemetryLog>(options.telemetry_path);
+    }
+    store.SetConcurrent(scheduler.GetNumThreads() > 1);
+
+    for (int n = 0; n < tree.GetNumNodes(); ++n)
+        terminal_counts[n + 1] = terminal_counts[n]
+                                 + (tree.GetNode(n).type != PreflopTree::NodeType::DECISION);
+}
+
+size_t PreflopSolver::GetScratchSize() const {
+    // a decision keeps the strategy, and the reach and values of each child
+    return 3 * tree.GetMaxNumActions() * NUM_HANDS;
+}
+
+size_t PreflopSolver::GetWalkScratchSize() const {
+    return (tree.GetMaxDepth() + 1) * GetScratchSize();
+}
+
+template<typename F>
+void PreflopSolver::WalkChildren(const PreflopTree::TreeNode &node,
+                                 const std::span<double> child_scratch, const F &walk_child) const {
+    if (scheduler.GetNumThreads() == 1 || node.subtree_size < split_threshold) {
+        for (int a = 0; a < node.num_children; ++a)
+            walk_child(a, child_scratch);
+        return;
+    }
+
+    // the other children go to the deque for idle threads to steal, each walked on scratch of
+    // the thread that takes it
+    TaskScheduler::TaskGroup group(scheduler);
+    for (int a = 1; a < node.num_children; ++a)
+        group.Spawn([&, a](const int thread) {
+            ScratchArena &arena = scheduler.GetScratch(thread);
+            const ScratchArena::Mark mark = arena.GetMark();
+            walk_child(a, arena.Allocate(GetWalkScratchSize()));
+            arena.Release(mark);
+        });
+    walk_child(0, child_scratch);
+    group.Wait();
+}
+
+void PreflopSolver::train(const int num_iterations, const bool output) {
+    const auto start = std::chrono::steady_clock::now();
+    const int log_every = std::max(1, num_iterations / 10);
+    std::atomic<int> num_done = 0;
+    std::mutex output_mutex;
+    const auto run = [&](const size_t task, const int thread) {
+        RunIteration(num_iterations_done + static_cast<int64_t>(task), thread);
+
+        const int i = ++num_done;
+        if (output && (i % log_every == 0 || i == num_iterations)) {
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            std::lock_guard lock(output_mutex);
+            std::cout << "iteration " << i << "/" << num_iterations << " ("
+                      << i / elapsed.count() << " iterations/s)" << std::endl;
+        }
+    };
+
+    // the strategies the first report compares against
+    if (telemetry_interval > 0 && reported_strategies.empty()) {
+        size_t size = 0;
+        for (int d = 0; d < store.GetNumDecisions(); ++d)
+            size += store.GetNumActions(d) * NUM_HANDS;
+        reported_strategies.resize(size);
+        GetAverageStrategies(reported_strategies);
+    }
+
+    // the iterations between two discounts, checkpoints or reports run concurrently, and the
+    // discount, checkpoint or report waits for them
+    auto batch_start = std::chrono::steady_clock::now();
+    for (int remaining = num_iterations; remaining > 0;) {
+        int64_t batch = remaining;
+        if (rule.Discounts())
+            batch = std::min(batch, discount_interval - num_iterations_done % discount_interval);
+        if (checkpoint_writer)
+            batch = std::min(batch,
+                             checkpoint_interval - num_iterations_done % checkpoint_interval);
+        if (telemetry_interval > 0)
+            batch = std::min(batch, telemetry_interval - num_iterations_done % telemetry_interval);
+        scheduler.ParallelFor(batch, run);
+        num_iterations_done += batch;
+        remaining -= static_cast<int>(batch);
+
+        // the nodes walked are only counted for reports; a FULL iteration walks the whole tree
+        // once per player
+        if (telemetry_interval > 0) {
+            if (mode == TrainingMode::FULL) {
+                num_nodes_walked += 2 * batch * tree.GetNumNodes();
+                num_terminals_walked += 2 * batch * terminal_counts.back();
+            } else
+                for (WalkCounts &counts: walk_counts) {
+                    num_nodes_walked += std::exchange(counts.nodes, 0);
+                    num_terminals_walked += std::exchange(counts.terminals, 0);
+                }
+        }
+
+        if (rule.Discounts() && num_iterations_done % discount_interval == 0) {
+            const int64_t t = num_iterations_done / discount_interval;
+            store.Discount(rule.GetPositiveRegretDiscount(t), rule.GetNegativeRegretDiscount(t),
+                           rule.GetStrategyDiscount(t));
+        }
+        // the copy is taken here, and saved while the next batch trains
+        if (checkpoint_writer && num_iterations_done % checkpoint_interval == 0)
+            checkpoint_writer->Submit(MakeCheckpoint());
+
+        const auto batch_end = std::chrono::steady_clock::now();
+        training_time += batch_end - batch_start;
+        report_time += batch_end - batch_start;
+        report_iterations += batch;
+        batch_start = batch_end;
+        // reports are measured outside the training time
+        if (telemetry_interval > 0 && num_iterations_done % telemetry_interval == 0) {
+            const TrainingTelemetry telemetry = MakeTelemetry();
+            if (telemetry_log)
+                telemetry_log->Write(telemetry);
+            if (telemetry_callback)
+                telemetry_callback(telemetry);
+            batch_start = std::chrono::steady_clock::now();
+        }
+    }
+}
+
+int PreflopSolver::train(const StoppingRule &stop, const bool output) {
+    if (stop.target_exploitability <= 0 && stop.time_budget.count() <= 0
+        && stop.max_iterations <= 0)
+        throw std::invalid_argument("stopping rule sets no limit");
+    if (stop.check_interval <= 0)
+        throw std::invalid_argument("check_interval must be positive");
+
+    const auto start = std::chrono::steady_clock::now();
+    int num_iterations = 0;
+    while (true) {
+        const int batch = stop.max_iterations > 0
+                              ? std::min(stop.check_interval, stop.max_iterations - num_iterations)
+                              : stop.check_interval;
+        train(batch);
+        num_iterations += batch;
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        const double exploitability = stop.target_exploitability > 0 ? get_exploitability() : 0;
+        if (output) {
+            std::cout << "iteration " << num_iterations << " ("
+                      << num_iterations / elapsed.count() << " iterations/s)";
+            if (stop.target_exploitability > 0)
+                std::cout << ", exploitability " << exploitability << " bb/hand";
+            std::cout << std::endl;
+        }
+
+        if ((stop.target_exploitability > 0 && exploitability <= stop.target_exploitability)
+            || (stop.time_budget.count() > 0 && elapsed >= stop.time_budget)
+            || (stop.max_iterations > 0 && num_iterations >= stop.max_iterations))
+            return num_iterations;
+    }
+}
+
+void PreflopSolver::RunIteration(const int64_t iteration, const int thread) {
+    ScratchArena &arena = scheduler.GetScratch(thread);
+    const ScratchArena::Mark mark = arena.GetMark();
+    const std::span<double> scratch = arena.Allocate(GetWalkScratchSize());
+    if (mode == TrainingMode::FULL) {
+        const std::span<double> ones = arena.Allocate(NUM_HANDS);
+        const std::span<double> values = arena.Allocate(NUM_HANDS);
+        std::fill(ones.begin(), ones.end(), 1.0);
+        Walk(0, 1, scratch, ones, ones, values);
+        Walk(0, 2, scratch, ones, ones, values);
+    } else {
+        Rng rng(seed + iteration);
+        const Deal deal = Sample(rng);
+        if (telemetry_interval > 0)
+            WalkSampled<true>(deal, scratch, rng, walk_counts[thread]);
+        else
+            WalkSampled<false>(deal, scratch, rng, walk_counts[thread]);
+    }
+    arena.Release(mark);
+}
+
+template<bool COUNT>
+void PreflopSolver::WalkSampled(const Deal &deal, const std::span<double> scratch, Rng &rng,
+                                WalkCounts &counts) {
+    for (const int player: {1, 2})
+        switch (mode) {
+            case TrainingMode::CHANCE_SAMPLING:
+                WalkChance<COUNT>(0, player, deal, scratch, 1, 1, counts);
+                break;
+            case TrainingMode::EXTERNAL_SAMPLING:
+                WalkExternal<COUNT>(0, player, deal, scratch, rng, counts);
+                break;
+            default:
+                WalkOutcome<COUNT>(0, player, deal, scratch, rng, 1, 1, 1, counts);
+        }
+}
+
+void PreflopSolver::Walk(const int node, const int player, const std::span<double> scratch,
+                         const std::span<const double> reach,
+                         const std::span<const double> opponent_reach,
+                         const std::span<double> values) {
+    const PreflopTree::TreeNode &tree_node = tree.GetNode(node);
+    if (tree_node.type != PreflopTree::NodeType::DECISION) {
+        GetTerminalValues(tree_node, player, opponent_reach, values);
+        return;
+    }
+
+    const std::span<const int> children = tree.GetChildren(node);
+    const size_t num_actions = children.size();
+    const size_t size = num_actions * NUM_HANDS;
+    const std::span<double> strategies = scratch.first(size);
+    const std::span<double> child_reaches = scratch.subspan(size, size);
+    const std::span<double> child_values = scratch.subspan(2 * size, size);
+    const std::span<double> child_scratch = scratch.subspan(GetScratchSize());
+
+    // the strategy of whoever acts splits their reach between the actions
+    const bool acting = tree_node.player == player;
+    const std::span<const double> split_reach = acting ? reach : opponent_reach;
+    store.GetStrategy(tree_node.decision, strategies);
+    if (acting)
+        store.AddStrategy(tree_node.decision, reach, strategies);
+    for (size_t a = 0; a < num_actions; ++a)
+        for (int h = 0; h < NUM_HANDS; ++h)
+            child_reaches[a * NUM_HANDS + h] = split_reach[h] * strategies[a * NUM_HANDS + h];
+
+    // regret-based pruning skips an action no hand plays while its countdown runs
+    std::bitset<UINT8_MAX + 1> skipped;
+    if (acting && prune_threshold > 0)
+        for (size_t a = 0; a < num_actions; ++a) {
+            std::atomic<int> &countdown = prune_countdowns[tree_node.first_child + a];
+            if (countdown.load(std::memory_order_relaxed) > 0
+                && countdown.fetch_sub(1, std::memory_order_relaxed) > 0
+                && IsUnplayed(strategies.subspan(a * NUM_HANDS, NUM_HANDS))) {
+                skipped[a] = true;
+                const std::span<double> child_value = child_values.subspan(a * NUM_HANDS,
+                                                                           NUM_HANDS);
+                std::fill(child_value.begin(), child_value.end(), 0.0);
+                num_subtrees_skipped.fetch_add(1, std::memory_order_relaxed);
+                const int child = children[a];
+                const int end = child + tree.GetNode(child).subtree_size;
+                num_nodes_skipped.fetch_add(end - child, std::memory_order_relaxed);
+                num_terminals_skipped.fetch_add(terminal_counts[end] - terminal_counts[child],
+                                                std::memory_order_relaxed);
+            }
+        }
+
+    const auto walk_child = [&](const size_t a, const std::span<double> walk_scratch) {
+        if (skipped[a])
+            return;
+        const std::span<const double> child_reach = child_reaches.subspan(a * NUM_HANDS,
+                                                                          NUM_HANDS);
+        Walk(children[a], player, walk_scratch, acting ? child_reach : reach,
+             acting ? opponent_reach : child_reach, child_values.subspan(a * NUM_HANDS, NUM_HANDS));
+    };
+    WalkChildren(tree_node, child_scratch, walk_child);
+
+    std::fill(values.begin(), values.end(), 0.0);
+    if (!acting) {
+        for (size_t a = 0; a < num_actions; ++a)
+            for (int h = 0; h < NUM_HANDS; ++h)
+                values[h] += child_values[a * NUM_HANDS + h];
+        return;
+    }
+
+    for (size_t a = 0; a < num_actions; ++a)
+        for (int h = 0; h < NUM_HANDS; ++h)
+            values[h] += strategies[a * NUM_HANDS + h] * child_values[a * NUM_HANDS + h];
+    // the values are already weighted by the opponent's reach, so they are counterfactual
+    for (size_t a = 0; a < num_actions; ++a)
+        for (int h = 0; h < NUM_HANDS; ++h)
+            child_values[a * NUM_HANDS + h] = skipped[a]
+                                                  ? 0
+                                                  : child_values[a * NUM_HANDS + h] - values[h];
+    store.AddRegrets(tree_node.decision, child_values);
+
+    if (prune_threshold > 0)
+        for (size_t a = 0; a < num_actions; ++a)
+            if (!skipped[a] && IsUnplayed(strategies.subspan(a * NUM_HANDS, NUM_HANDS))
+                && IsHopeless(tree_node.decision, static_cast<int>(a))) {
+                prune_countdowns[tree_node.first_child + a].store(prune_iterations,
+                                                                  std::memory_order_relaxed);
+                num_actions_pruned.fetch_add(1, std::memory_order_relaxed);
+            }
+}
+
+bool PreflopSolver::IsUnplayed(const std::span<const double> strategy) {
+    return std::ranges::all_of(strategy, [](const double p) { return p == 0; });
+}
+
+bool PreflopSolver::IsHopeless(const int decision, const int action) const {
+    const ClassMatchups &matchups = *class_matchups;
+    for (int h = 0; h < NUM_HANDS; ++h)
+        if (store.GetRegret(decision, h, action) >= -prune_threshold * matchups.totals[h])
+            return false;
+    return true;
+}
+
+// Sample an action from a distribution.
+static int SampleAction(const std::span<const double> probabilities, Rng &rng) {
+    double u = rng.NextDouble();
+    const int last = static_cast<int>(probabilities.size()) - 1;
+    for (int a = 0; a < last; ++a) {
+        u -= probabilities[a];
+        if (u < 0)
+            return a;
+    }
+    return last;
+}
+
+PreflopSolver::Deal PreflopSolver::Sample(Rng &rng) const {
+    const int combo = static_cast<int>(rng.Below(Utils::NUM_COMBOS));
+    const auto [c1, c2] = Utils::ComboToIndices(combo);
+    int opponent_combo;
+    while (true) {
+        opponent_combo = static_cast<int>(rng.Below(Utils::NUM_COMBOS));
+        const auto [o1, o2] = Utils::ComboToIndices(opponent_combo);
+        if (c1 != o1 && c1 != o2 && c2 != o1 && c2 != o2)
+            break;
+    }
+
+    const ClassMatchups &matchups = *class_matchups;
+    const int h1 = Utils::ComboToHandClass(combo), h2 = Utils::ComboToHandClass(opponent_combo);
+    const int matchup = NUM_HANDS * h1 + h2;
+    return {{h1, h2}, matchups.equities[matchup] / matchups.weights[matchup]};
+}
+
+template<bool COUNT>
+double PreflopSolver::WalkChance(const int node, const int player, const Deal &deal,
+                                 const std::span<double> scratch, const double reach,
+                                 const double opponent_reach, WalkCounts &counts) {
+    const PreflopTree::TreeNode &tree_node = tree.GetNode(node);
+    if constexpr (COUNT)
+        ++counts.nodes;
+    if (tree_node.type != PreflopTree::NodeType::DECISION) {
+        if constexpr (COUNT)
+            ++counts.terminals;
+        return GetTerminalValue(tree_node, player, deal);
+    }
+
+    const std::span<const int> children = tree.GetChildren(node);
+    const size_t num_actions = children.size();
+    const int hand = deal.hands[tree_node.player - 1];
+    const std::span<double> strategy = scratch.first(num_actions);
+    const std::span<double> action_values = scratch.subspan(num_actions, num_actions);
+    const std::span<double> child_scratch = scratch.subspan(GetScratchSize());
+    store.GetStrategy(tree_node.decision, hand, strategy);
+
+    const bool acting = tree_node.player == player;
+    double value = 0;
+    for (size_t a = 0; a < num_actions; ++a) {
+        action_values[a] = acting
+                               ? WalkChance<COUNT>(children[a], player, deal, child_scratch,
+                                                   reach * strategy[a], opponent_reach, counts)
+                               : WalkChance<COUNT>(children[a], player, deal, child_scratch,
+                                                   reach, opponent_reach * strategy[a], counts);
+        value += strategy[a] * action_values[a];
+    }
+
+    if (acting)
+        for (size_t a = 0; a < num_actions; ++a) {
+            store.AddRegret(tree_node.decision, hand, static_cast<int>(a),
+                            opponent_reach * (action_values[a] - value));
+            store.AddStrategySum(tree_node.decision, hand, static_cast<int>(a),
+                                 reach * strategy[a]);
+        }
+    return value;
+}
+
+template<bool COUNT>
+double PreflopSolver::WalkExternal(const int node, const int player, const Deal &deal,
+                                   const std::span<double> scratch, Rng &rng,
+                                   WalkCounts &counts) {
+    const PreflopTree::TreeNode &tree_node = tree.GetNode(node);
+    if constexpr (COUNT)
+        ++counts.nodes;
+    if (tree_node.type != PreflopTree::NodeType::DECISION) {
+        if constexpr (COUNT)
+            ++counts.terminals;
+        return GetTerminalValue(tree_node, player, deal);
+    }
+
+    const std::span<const int> children = tree.GetChildren(node);
+    const size_t num_actions = children.size();
+    const int hand = deal.hands[tree_node.player - 1];
+    const std::span<double> strategy = scratch.first(num_actions);
+    const std::span<double> action_values = scratch.subspan(num_actions, num_actions);
+    const std::span<double> child_scratch = scratch.subspan(GetScratchSize());
+    store.GetStrategy(tree_node.decision, hand, strategy);
+
+    if (tree_node.player != player) {
+        // the opponent plays on-policy, so their strategy is averaged where they are sampled
+        for (size_t a = 0; a < num_actions; ++a)
+            store.AddStrategySum(tree_node.decision, hand, static_cast<int>(a), strategy[a]);
+        const int a = SampleAction(strategy, rng);
+        return WalkExternal<COUNT>(children[a], player, deal, child_scratch, rng, counts);
+    }
+
+    double value = 0;
+    for (size_t a = 0; a < num_actions; ++a) {
+        action_values[a] = WalkExternal<COUNT>(children[a], player, deal, child_scratch, rng,
+                                               counts);
+        value += strategy[a] * action_values[a];
+    }
+    for (size_t a = 0; a < num_actions; ++a)
+        store.AddRegret(tree_node.decision, hand, static_cast<int>(a), action_values[a] - value);
+    return value;
+}
+
+template<bool COUNT>
+double PreflopSolver::WalkOutcome(const int node, const int player, const Deal &deal,
+                                  const std::span<double> scratch, Rng &rng, const double reach,
+                                  const double opponent_reach, const double sample_reach,
+                                  WalkCounts &counts) {
+    const PreflopTree::TreeNode &tree_node = tree.GetNode(node);
+    if constexpr (COUNT)
+        ++counts.nodes;
+    if (tree_node.type != PreflopTree::NodeType::DECISION) {
+        if constexpr (COUNT)
+            ++counts.terminals;
+        return GetTerminalValue(tree_node, player, deal);
+    }
+
+    const std::span<const int> children = tree.GetChildren(node);
+    const size_t num_actions = children.size();
+    const int hand = deal.hands[tree_node.player - 1];
+    const std::span<double> strategy = scratch.first(num_actions);
+    const std::span<double> probabilities = scratch.subspan(num_actions, num_actions);
+    const std::span<double> child_scratch = scratch.subspan(GetScratchSize());
+    store.GetStrategy(tree_node.decision, hand, strategy);
+
+    // the updated player explores, so that every action keeps being sampled
+    const bool acting = tree_node.player == player;
+    for (size_t a = 0; a < num_actions; ++a)
+        probabilities[a] = acting
+                               ? exploration / num_actions + (1 - exploration) * strategy[a]
+                               : strategy[a];
+    const int a = SampleAction(probabilities, rng);
+    const double child_value = WalkOutcome<COUNT>(
+        children[a], player, deal, child_scratch, rng, acting ? reach * strategy[a] : reach,
+        acting ? opponent_reach : opponent_reach * strategy[a], sample_reach * probabilities[a],
+        counts);
+
+    // the sampled action's value, importance-weighted, stands in for every action's: the others
+    // count as 0
+    const double action_value = child_value / probabilities[a];
+    const double value = strategy[a] * action_value;
+    if (acting)
+        for (size_t b = 0; b < num_actions; ++b) {
+            const int action = static_cast<int>(b);
+            store.AddRegret(tree_node.decision, hand, action,
+                            opponent_reach / sample_reach
+                            * ((action == a ? action_value : 0) - value));
+            store.AddStrategySum(tree_node.decision, hand, action,
+                                 reach / sample_reach * strategy[b]);
+        }
+    return value;
+}
+
+double PreflopSolver::GetTerminalValue(const PreflopTree::TreeNode &node, const int player,
+                                       const Deal &deal) const {
+    const double bet = player == 1 ? node.p1_bet : node.p2_bet;
+    const double opponent_bet = player == 1 ? node.p2_bet : node.p1_bet;
+    if (node.type == PreflopTree::NodeType::FOLD)
+        return node.player == player ? -bet : opponent_bet;
+
+    // as in GetTerminalValues
+    const double pot = bet + opponent_bet;
+    const double p1_share = pot * (node.all_in ? 1.0 : p1_equity_multiplier) * deal.p1_equity;
+    return player == 1 ? p1_share - bet : pot - bet - p1_share;
+}
+
+void PreflopSolver::WalkBestResponse(const int node, const int player,
+                                     const std::span<double> scratch,
+                                     const std::span<const double> opponent_reach,
+                                     const std::span<double> values) const {
+    const PreflopTree::TreeNode &tree_node = tree.GetNode(node);
+    if (tree_node.type != PreflopTree::NodeType::DECISION) {
+        GetTerminalValues(tree_node, player, opponent_reach, values);
+        return;
+    }
+
+    const std::span<const int> children = tree.GetChildren(node);
+    const size_t num_actions = children.size();
+    const size_t size = num_actions * NUM_HANDS;
+    const std::span<double> strategies = scratch.first(size);
+    const std::span<double> child_reaches = scratch.subspan(size, size);
+    const std::span<double> child_values = scratch.subspan(2 * size, size);
+    const std::span<double> child_scratch = scratch.subspan(GetScratchSize());
+
+    // the opponent's average strategy splits their reach; the player's own reach doesn't
+    // matter, since a best response picks the best action for every hand separately
+    const bool acting = tree_node.player == player;
+    if (!acting) {
+        store.GetAverageStrategy(tree_node.decision, strategies);
+        for (size_t a = 0; a < num_actions; ++a)
+            for (int h = 0; h < NUM_HANDS; ++h)
+                child_reaches[a * NUM_HANDS + h] = opponent_reach[h]
+                                                   * strategies[a * NUM_HANDS + h];
+    }
+
+    WalkChildren(tree_node, child_scratch, [&](const size_t a,
+                                               const std::span<double> walk_scratch) {
+        WalkBestResponse(children[a], player, walk_scratch,
+                         acting ? opponent_reach : child_reaches.subspan(a * NUM_HANDS, NUM_HANDS),
+                         child_values.subspan(a * NUM_HANDS, NUM_HANDS));
+    });
+
+    if (acting) {
+        std::copy_n(child_values.begin(), NUM_HANDS, values.begin());
+        for (size_t a = 1; a < num_actions; ++a)
+            for (int h = 0; h < NUM_HANDS; ++h)
+                values[h] = std::max(values[h], child_values[a * NUM_HANDS + h]);
+    } else {
+        std::fill(values.begin(), values.end(), 0.0);
+        for (size_t a = 0; a < num_actions; ++a)
+            for (int h = 0; h < NUM_HANDS; ++h)
+                values[h] += child_values[a * NUM_HANDS + h];
+    }
+}
+
+void PreflopSolver::GetTerminalValues(const PreflopTree::TreeNode &node, const int player,
+                                      const std::span<const double> opponent_reach,
+                                      const std::span<double> values) const {
+    const ClassMatchups &matchups = *class_matchups;
+    const double bet = player == 1 ? node.p1_bet : node.p2_bet;
+    const double opponent_bet = player == 1 ? node.p2_bet : node.p1_bet;
+
+    if (node.type == PreflopTree::NodeType::FOLD) {
+        const double utility = node.player == player ? -bet : opponent_bet;
+        for (int h = 0; h < NUM_HANDS; ++h) {
+            const double *const weights = &matchups.weights[NUM_HANDS * h];
+            double weight = 0;
+            for (int o = 0; o < NUM_HANDS; ++o)
+                weight += opponent_reach[o] * weights[o];
+            values[h] = utility * weight;
+        }
+        return;
+    }
+
+    // at showdown p1 realizes only p1_equity_multiplier of their equity when there is postflop
+    // play left, and all of it when someone is all-in; p2 gets the rest of the pot
+    const double pot = bet + opponent_bet;
+    const double multiplier = node.all_in ? 1.0 : p1_equity_multiplier;
+    for (int h = 0; h < NUM_HANDS; ++h) {
+        const double *const weights = &matchups.weights[NUM_HANDS * h];
+        double weight = 0, p1_equity = 0;
+        for (int o = 0; o < NUM_HANDS; ++o) {
+            weight += opponent_reach[o] * weights[o];
+            p1_equity += opponent_reach[o] * (player == 1
+                                                  ? matchups.equities[NUM_HANDS * h + o]
+                                                  : matchups.equities[NUM_HANDS * o + h]);
+        }
+
+        const double p1_share = pot * multiplier * p1_equity;
+        values[h] = player == 1 ? p1_share - bet * weight : (pot - bet) * weight - p1_share;
+    }
+}
+
+void PreflopSolver::GetAverageStrategies(const std::span<double> strategies) const {
+    size_t offset = 0;
+    for (int d = 0; d < store.GetNumDecisions(); ++d) {
+        const size_t size = store.GetNumActions(d) * NUM_HANDS;
+        store.GetAverageStrategy(d, strategies.subspan(offset, size));
+        offset += size;
+    }
+}
+
+TrainingTelemetry PreflopSolver::MakeTelemetry() {
+    const ClassMatchups &matchups = *class_matchups;
+    TrainingTelemetry telemetry{};
+    telemetry.iteration = num_iterations_done;
+    telemetry.elapsed_seconds = training_time.count();
+    telemetry.iterations_per_second = report_iterations / report_time.count();
+    telemetry.nodes_visited = num_nodes_walked - num_nodes_skipped.load();
+    telemetry.terminal_evaluations = num_terminals_walked - num_terminals_skipped.load();
+    telemetry.memory_usage = get_memory_usage();
+    if (telemetry_exploitability)
+        telemetry.exploitability = get_exploitability();
+    report_iterations = 0;
+    report_time = {};
+
+    // a FULL iteration adds each hand's regrets over every deal of it, while a sampled one adds
+    // them for a single deal, drawn with probability totals[h] / num_deals
+    double num_deals = 0;
+    for (const double total: matchups.totals)
+        num_deals += total;
+    const double deals_per_iteration = mode == TrainingMode::FULL ? 1 : num_deals;
+
+    std::vector<double> strategies(reported_strategies.size());
+    GetAverageStrategies(strategies);
+    size_t offset = 0;
+    int64_t num_infosets = 0;
+    for (int d = 0; d < store.GetNumDecisions(); ++d) {
+        const int num_actions = store.GetNumActions(d);
+        for (int h = 0; h < NUM_HANDS; ++h) {
+            double regret = 0, change = 0;
+            for (int a = 0; a < num_actions; ++a) {
+                regret = std::max(regret, store.GetRegret(d, h, a));
+                const size_t i = offset + static_cast<size_t>(a) * NUM_HANDS + h;
+                change += std::abs(strategies[i] - reported_strategies[i]);
+            }
+            telemetry.average_positive_regret += regret * deals_per_iteration
+                    / (static_cast<double>(num_iterations_done) * matchups.totals[h]);
+            telemetry.strategy_change += change;
+            telemetry.max_strategy_change = std::max(telemetry.max_strategy_change, change);
+            ++num_infosets;
+        }
+        offset += static_cast<size_t>(num_actions) * NUM_HANDS;
+    }
+    if (num_infosets > 0) {
+        telemetry.average_positive_regret /= static_cast<double>(num_infosets);
+        telemetry.strategy_change /= static_cast<double>(num_infosets);
+    }
+    reported_strategies = std::move(strategies);
+    return telemetry;
+}
+
+Checkpoint::Config PreflopSolver::GetCheckpointConfig() const {
+    return {p1_starting_stack_depth, p2_starting_stack_depth, p1_equity_multiplier, p1_position,
+            p2_position, num_max_raises, 0};
+}
+
+Checkpoint::Data PreflopSolver::MakeCheckpoint() const {
+    Checkpoint::Data data{GetCheckpointConfig(), num_iterations_done, store.GetPrecision(),
+                          store.GetNumHands(), {}, {}, {}, {}};
+    GetCheckpointTree(tree, data.nodes, data.actions);
+    data.regrets.assign(store.GetRegretData().begin(), store.GetRegretData().end());
+    data.strategy_sums.assign(store.GetStrategySumData().begin(),
+                              store.GetStrategySumData().end());
+    return data;
+}
+
+void PreflopSolver::save_checkpoint(const std::string &path) const {
+    Checkpoint::Save(path, MakeCheckpoint());
+}
+
+void PreflopSolver::resume(const std::string &path) {
+    const Checkpoint checkpoint = Checkpoint::Load(path);
+    if (checkpoint.GetConfig() != GetCheckpointConfig())
+        throw std::invalid_argument(path + " was saved for a different game");
+    if (checkpoint.GetPrecision() != store.GetPrecision()
+        || checkpoint.GetNumHands() != store.GetNumHands())
+        throw std::invalid_argument(path + " was saved with a different precision");
+
+    // the tree must match node for node, so that every value lands on its information set
+    std::vector<Checkpoint::Node> nodes;
+    std::vector<Checkpoint::ActionKind> actions;
+    GetCheckpointTree(tree, nodes, actions);
+    if (!std::ranges::equal(checkpoint.GetNodes(), nodes)
+        || !std::ranges::equal(checkpoint.GetActions(), actions))
+        throw std::invalid_argument(path + " was saved for a different tree");
+
+    store.Load(checkpoint.GetRegretData(), checkpoint.GetStrategySumData());
+    num_iterations_done = checkpoint.GetNumIterations();
+    for (std::atomic<int> &countdown: prune_countdowns)
+        countdown.store(0, std::memory_order_relaxed);
+}
+
+void PreflopSolver::wait_for_checkpoints() {
+    if (checkpoint_writer)
+        checkpoint_writer->Flush();
+}
+
+void PreflopSolver::WarmStart(const std::span<const Checkpoint::Node> nodes,
+                              const std::span<const Checkpoint::ActionKind> actions,
+                              const InfosetStore &prior, const int64_t num_iterations,
+                              const double weight) {
+    if (weight < 0)
+        throw std::invalid_argument("weight must not be negative");
+    const CheckpointTree saved(nodes, actions);
+    std::vector<Checkpoint::Node> target_nodes;
+    std::vector<Checkpoint::ActionKind> target_actions;
+    GetCheckpointTree(tree, target_nodes, target_actions);
+    const CheckpointTree target(target_nodes, target_actions);
+
+    // regret matching doesn't depend on the scale of the regrets, and the average strategy not
+    // on that of the sums, so this scale only sets how many of this solver's iterations the
+    // prior outweighs
+    const double scale = weight / static_cast<double>(std::max<int64_t>(num_iterations, 1));
+    store.Discount(0, 0, 0);
+
+    // walk both trees from their roots, following at each decision the prior's action of the
+    // same kind, the one closest in size if there are several, wherever the player to act and
+    // the kind of node agree
+    const auto map = [&](const auto &self, const int t, const int s) -> void {
+        const Checkpoint::Node &node = target.nodes[t], &saved_node = saved.nodes[s];
+        if (target.decisions[t] < 0 || saved.decisions[s] < 0 || node.player != saved_node.player)
+            return;
+
+        for (int a = 0; a < node.num_children; ++a) {
+            const Checkpoint::ActionKind kind = target.actions[target.first_edge[t] + a];
+            const double bet = GetBet(target.nodes[target.children[target.first_edge[t] + a]],
+                                      node.player);
+            int match = -1;
+            double distance = 0;
+            for (int b = 0; b < saved_node.num_children; ++b) {
+                if (saved.actions[saved.first_edge[s] + b] != kind)
+                    continue;
+                const double d = std::abs(
+                    GetBet(saved.nodes[saved.children[saved.first_edge[s] + b]], node.player)
+                    - bet);
+                if (match < 0 || d < distance) {
+                    match = b;
+                    distance = d;
+                }
+            }
+            if (match < 0)
+                continue;
+
+            for (int h = 0; h < NUM_HANDS; ++h) {
+                store.AddRegret(target.decisions[t], h, a,
+                                scale * prior.GetRegret(saved.decisions[s], h, match));
+                store.AddStrategySum(target.decisions[t], h, a,
+                                     scale * prior.GetStrategySum(saved.decisions[s], h, match));
+            }
+            self(self, target.children[target.first_edge[t] + a],
+                 saved.children[saved.first_edge[s] + match]);
+        }
+    };
+    if (!nodes.empty())
+        map(map, 0, 0);
+
+    // training starts over: the discount schedule, checkpoints and reports count from here
+    num_iterations_done = 0;
+    reported_strategies.clear();
+    report_iterations = 0;
+    report_time = {};
+    for (std::atomic<int> &countdown: prune_countdowns)
+        countdown.store(0, std::memory_order_relaxed);
+}
+
+void PreflopSolver::warm_start(const PreflopSolver &prior, const double weight) {
+    std::vector<Checkpoint::Node> nodes;
+    std::vector<Checkpoint::ActionKind> actions;
+    GetCheckpointTree(prior.tree, nodes, actions);
+    WarmStart(nodes, actions, prior.store, prior.num_iterations_done, weight);
+}
+
+void PreflopSolver::warm_start(const std::string &path, const double weight) {
+    const Checkpoint checkpoint = Checkpoint::Load(path);
+    if (checkpoint.GetNumHands() != NUM_HANDS)
+        throw std::invalid_argument(path + " was saved with different hands");
+
+    const CheckpointTree saved(checkpoint.GetNodes(), checkpoint.GetActions());
+    InfosetStore prior(saved.GetNumActions(), NUM_HANDS, checkpoint.GetPrecision());
+    prior.Load(checkpoint.GetRegretData(), checkpoint.GetStrategySumData());
+    WarmStart(checkpoint.GetNodes(), checkpoint.GetActions(), prior,
+              checkpoint.GetNumIterations(), weight);
+}
+
+int64_t PreflopSolver::get_num_iterations() const {
+    return num_iterations_done;
+}
+
+size_t PreflopSolver::get_memory_usage() const {
+    return store.GetFootprint();
+}
+
+double PreflopSolver::get_best_response_value(const int player) const {
+    const ClassMatchups &matchups = *class_matchups;
+    double value = 0;
+    scheduler.Run([&](const int thread) {
+        ScratchArena &arena = scheduler.GetScratch(thread);
+        const ScratchArena::Mark mark = arena.GetMark();
+        const std::span<double> ones = arena.Allocate(NUM_HANDS);
+        const std::span<double> values = arena.Allocate(NUM_HANDS);
+        std::fill(ones.begin(), ones.end(), 1.0);
+        WalkBestResponse(0, player, arena.Allocate(GetWalkScratchSize()), ones, values);
+        for (const double v: values)
+            value += v;
+        arena.Release(mark);
+    });
+
+    // the values are summed over every pair of disjoint combos
+    double num_deals = 0;
+    for (const double total: matchups.totals)
+        num_deals += total;
+    return value / num_deals;
+}
+
+PruningStats PreflopSolver::get_pruning_stats() const {
+    const int64_t nodes_skipped = num_nodes_skipped.load();
+    const int64_t nodes_walked = mode == TrainingMode::FULL
+                                     ? 2 * num_iterations_done * tree.GetNumNodes() - nodes_skipped
+                                     : 0;
+    return {nodes_walked, nodes_skipped, num_actions_pruned.load(), num_subtrees_skipped.load()};
+}
+
+double PreflopSolver::get_exploitability() const {
+    return (get_best_response_value(1) + get_best_response_value(2)) / 2;
+}
+
+Range PreflopSolver::get_range(const int player) const {
+    if (tree.GetNode(0).player == player)
+        return get_range(player, {});
+
+    const std::span<const int> children = tree.GetChildren(0);
+    for (size_t a = 0; a < children.size(); ++a)
+        if (tree.GetNode(children[a]).type == PreflopTree::NodeType::DECISION)
+            return get_range(player, {tree.GetAction(0, static_cast<int>(a))});
+    throw std::invalid_argument("player never gets to act");
+}
+
+Range PreflopSolver::get_range(const int player,
+                               const std::vector<std::shared_ptr<PreflopAction> > &history) const {
+    const int node = tree.FindNode(history);
+    if (node < 0 || tree.GetNode(node).type != PreflopTree::NodeType::DECISION
+        || tree.GetNode(node).player != player)
+        throw std::invalid_argument("history does not lead to a decision of this player");
+
+    const PreflopTree::TreeNode &tree_node = tree.GetNode(node);
+    std::vector<double> strategy(static_cast<size_t>(tree_node.num_children) * NUM_HANDS);
+    store.GetAverageStrategy(tree_node.decision, strategy);
+
+    auto frequencies = std::make_unique<std::unordered_map<std::string,
+        std::unordered_map<std::shared_ptr<PreflopAction>, double> > >();
+    for (int h = 0; h < NUM_HANDS; ++h) {
+        auto &hand_frequencies = (*frequencies)[Utils::HandClassToString(h)];
+        for (int a = 0; a < tree_node.num_children; ++a)
+            hand_frequencies[tree.GetAction(node, a)] = strategy[a * NUM_HANDS + h];
+    }
+    return Range(std::move(frequencies));
+}
@@ -4,19 +4,303 @@
 
 #ifndef SOLVER_H
 #define SOLVER_H
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
 #include <vector>
+#include "checkpoint/checkpoint.h"
+#include "game_state/game_state.h"
+#include "infoset_store/infoset_store.h"
+#include "node/node.h"
 #include "preflop_action/preflop_action.h"
+#include "preflop_tree/preflop_tree.h"
 #include "range/range.h"
+#include "telemetry/telemetry.h"
+#include "update_rule/update_rule.h"
+#include "solver/utils/rng.h"
+#include "solver/utils/task_scheduler.h"
+
+// How an iteration of training walks the tree. The sampling modes (Monte Carlo CFR) deal one
+// pair of hands per iteration, which makes iterations far cheaper but noisier.
+enum class TrainingMode : uint8_t {
+    // every hand class of both players at once, through every action
+    FULL,
+    // one deal, through every action
+    CHANCE_SAMPLING,
+    // one deal, through every action of the player updated and one sampled action of the
+    // opponent at each of theirs
+    EXTERNAL_SAMPLING,
+    // one deal and a single sampled path through the tree
+    OUTCOME_SAMPLING
+};
+
+// Settings of a PreflopSolver that don't change the game.
+struct SolverOptions {
+    // the type regrets and strategy sums are stored as; floats take half the memory, and the
+    // fixed-point precisions less still but only train on one thread
+    InfosetStore::Precision precision = InfosetStore::Precision::DOUBLE;
+    // threads to train on, counting the caller; 0 means one per hardware thread
+    int num_threads = 1;
+    // with several threads, a decision whose subtree has at least this many nodes walks its
+    // children as separate tasks, so that idle threads can steal them
+    int split_threshold = 32;
+    TrainingMode mode = TrainingMode::FULL;
+    // with outcome sampling, the probability of exploring a uniformly random action instead of
+    // following the current strategy at the updated player's decisions
+    double exploration = 0.6;
+    // seed of the deals and actions sampled; iteration i uses stream seed + i
+    uint64_t seed = 0;
+    // how iterations are weighed against each other
+    UpdateRule rule = UpdateRule::Vanilla();
+    // regret-based pruning, with FULL training: an action that no hand plays and whose regret
+    // is below -prune_threshold big blinds per deal for every hand is skipped, and its regrets
+    // left as they are, for prune_iterations iterations before it's walked and checked again;
+    // 0 turns pruning off
+    double prune_threshold = 0;
+    int prune_iterations = 20;
+    // iterations between discounts of a discounting rule, which count as one iteration of the
+    // rule; sampled iterations each update one deal, so they are best discounted in batches
+    int discount_interval = 1;
+    // file to save the training state to every checkpoint_interval iterations, on a background
+    // thread; 0 never saves
+    std::string checkpoint_path;
+    int checkpoint_interval = 0;
+    // a table saved by gen_preflop_equity to read exact all-in equities from, or if empty the
+    // one in data/; with estimate_equities they are instead estimated once per process from a
+    // thousand sampled boards per matchup, which takes seconds and leaves a few percent of noise
+    std::string equity_table;
+    bool estimate_equities = false;
+    // report on training every telemetry_interval iterations, appending each report to
+    // telemetry_path as a JSON line and passing it to telemetry_callback, whichever are set;
+    // 0 never reports, and then the walks count no nodes
+    int telemetry_interval = 0;
+    std::string telemetry_path;
+    std::function<void(const TrainingTelemetry &)> telemetry_callback;
+    // whether reports measure exploitability, which takes about as long as an iteration of FULL
+    // training
+    bool telemetry_exploitability = false;
+};
+
+// When to stop training: as soon as any of the limits that are set is reached.
+struct StoppingRule {
+    // exploitability of the average strategy to reach, in big blinds per hand; 0 to not check
+    double target_exploitability = 0;
+    // wall-clock time to train for; 0 for no limit
+    std::chrono::duration<double> time_budget{0};
+    // iterations to train for; 0 for no limit
+    int max_iterations = 0;
+    // iterations between two checks of the limits; exploitability takes about as long to
+    // measure as an iteration of FULL training
+    int check_interval = 10;
+};
+
+// The work regret-based pruning saved, over every call to train.
+struct PruningStats {
+    // nodes the FULL walks went through
+    int64_t nodes_walked;
+    // nodes in the subtrees they skipped
+    int64_t nodes_skipped;
+    // times an action started being pruned
+    int64_t actions_pruned;
+    // times the subtree of a pruned action was skipped
+    int64_t subtrees_skipped;
+};
+
+struct ClassMatchups;
 
 /**
  * Represents a GTO preflop solver for No-Limit Texas Hold'Em. A PreflopSolver can train for a set
  * number of iterations, and can return the solution as a Range object. Only heads-up is supported.
+ *
+ * Training is vectorized CFR over the 169 hand classes: each iteration walks the public betting
+ * tree once per player, carrying the reach probability of every hand class of both players, so a
+ * single walk updates the regrets of every hand at once instead of sampling one deal at a time.
+ *
+ * With several threads, iterations run concurrently and large subtrees of a single iteration are
+ * split into tasks, balanced by work stealing. The threads share the regrets and strategy sums,
+ * which they update with relaxed atomic adds and no locks. The result then depends on how the
+ * threads interleave, but converges just the same.
  */
 class PreflopSolver {
     double p1_starting_stack_depth, p2_starting_stack_depth;
     int p1_position, p2_position, num_max_raises;
     double p1_equity_multiplier;
     std::vector<std::shared_ptr<PreflopAction> > p1_action_space, p2_action_space;
+
+    // The public betting tree, shared by every hand.
+    PreflopTree tree;
+
+    // Regrets and strategy sums of each hand class at each decision.
+    InfosetStore store;
+
+    // mutable so that the const queries can run on it too
+    mutable TaskScheduler scheduler;
+    int split_threshold;
+    TrainingMode mode;
+    double exploration;
+    uint64_t seed;
+    UpdateRule rule;
+    int discount_interval;
+    double prune_threshold;
+    int prune_iterations;
+
+    // For each edge of the tree (indexed as in PreflopTree::GetChildren), the number of visits
+    // its subtree is still to be skipped for.
+    std::vector<std::atomic<int> > prune_countdowns;
+    std::atomic<int64_t> num_actions_pruned = 0, num_subtrees_skipped = 0, num_nodes_skipped = 0;
+
+    // Iterations trained so far, over every call to train.
+    int64_t num_iterations_done = 0;
+
+    int checkpoint_interval;
+    std::unique_ptr<CheckpointWriter> checkpoint_writer;
+
+    // The all-in equity of each hand class against each other, looked up at every showdown.
+    std::shared_ptr<const ClassMatchups> class_matchups;
+
+    // Nodes and terminal nodes visited by the sampling walks, counted by each thread on its own
+    // cache line and gathered after every batch of iterations; only counted for reports.
+    struct alignas(64) WalkCounts {
+        int64_t nodes = 0, terminals = 0;
+    };
+    std::vector<WalkCounts> walk_counts;
+
+    // terminal_counts[n] is the number of terminal nodes before node n in depth-first order, so
+    // that a subtree's terminals can be counted at once.
+    std::vector<int> terminal_counts;
+    std::atomic<int64_t> num_terminals_skipped = 0;
+
+    // Nodes and terminal nodes walked over every call to train, pruned subtrees included.
+    int64_t num_nodes_walked = 0, num_terminals_walked = 0;
+
+    int telemetry_interval;
+    bool telemetry_exploitability;
+    std::function<void(const TrainingTelemetry &)> telemetry_callback;
+    std::unique_ptr<TelemetryLog> telemetry_log;
+    // Time spent in train, and the iterations run and time spent since the last report.
+    std::chrono::duration<double> training_time{0}, report_time{0};
+    int64_t report_iterations = 0;
+    // The average strategies at the last report, laid out as the store's values, without padding.
+    std::vector<double> reported_strategies;
+
+    // A sampled pair of private hands.
+    struct Deal {
+        // hand class of each player
+        int hands[2];
+        // player 1's all-in equity against player 2
+        double p1_equity;
+    };
+
+    // The game, as a checkpoint records it.
+    [[nodiscard]] Checkpoint::Config GetCheckpointConfig() const;
+
+    // A copy of the training state, to be saved.
+    [[nodiscard]] Checkpoint::Data MakeCheckpoint() const;
+
+    // Measure the progress of training, as of the last iteration trained, and start the
+    // interval of the next report.
+    [[nodiscard]] TrainingTelemetry MakeTelemetry();
+
+    // Set each decision's average strategy, one after the other, laid out as in
+    // InfosetStore::GetStrategy.
+    void GetAverageStrategies(std::span<double> strategies) const;
+
+    // Replace the training state with a prior solution's, mapped from its tree onto this one.
+    void WarmStart(std::span<const Checkpoint::Node> nodes,
+                   std::span<const Checkpoint::ActionKind> actions, const InfosetStore &prior,
+                   int64_t num_iterations, double weight);
+
+    // The number of doubles of scratch that Walk uses at each depth.
+    [[nodiscard]] size_t GetScratchSize() const;
+
+    // The number of doubles of scratch a walk from any node may need: a block per depth.
+    [[nodiscard]] size_t GetWalkScratchSize() const;
+
+    /**
+     * Walk the subtree rooted at `node` for `player`, updating the player's regrets and average
+     * strategy, and set the counterfactual value of each of their hand classes.
+     * @param node the index of the node in the tree
+     * @param player the player to update
+     * @param scratch GetScratchSize() doubles for this node, followed by the same for each
+     *                depth below it
+     * @param reach the probability of each of `player`'s hand classes reaching this node
+     * @param opponent_reach the same for the opponent
+     * @param values set to the value of each hand class to `player`, weighted by the opponent's
+     *               reach
+     */
+    void Walk(int node, int player, std::span<double> scratch, std::span<const double> reach,
+              std::span<const double> opponent_reach, std::span<double> values);
+
+    // Whether a strategy plays an action with no hand.
+    static bool IsUnplayed(std::span<const double> strategy);
+
+    // Whether every hand's regret for an action is below the pruning threshold.
+    [[nodiscard]] bool IsHopeless(int decision, int action) const;
+
+    // Call walk_child(a, scratch) for each child of a node, with the scratch to walk the child
+    // on. At a large subtree with several threads, the children but the first are walked as
+    // tasks, each on scratch of its own.
+    template<typename F>
+    void WalkChildren(const PreflopTree::TreeNode &node, std::span<double> child_scratch,
+                      const F &walk_child) const;
+
+    // Run iteration `iteration` (counting from 0 over every call to train) on a thread.
+    void RunIteration(int64_t iteration, int thread);
+
+    // Walk one sampled deal for each player in the sampling mode, counting the nodes visited in
+    // counts if COUNT.
+    template<bool COUNT>
+    void WalkSampled(const Deal &deal, std::span<double> scratch, Rng &rng, WalkCounts &counts);
+
+    // Deal a pair of disjoint hands.
+    [[nodiscard]] Deal Sample(Rng &rng) const;
+
+    // Chance-sampled CFR: walk every action for one deal and return the value of the node to
+    // `player`. The reaches are those of the dealt hands.
+    template<bool COUNT>
+    double WalkChance(int node, int player, const Deal &deal, std::span<double> scratch,
+                      double reach, double opponent_reach, WalkCounts &counts);
+
+    // External-sampling CFR: walk every action of `player` and one of the opponent's, sampled
+    // from their strategy, and return the sampled value of the node.
+    template<bool COUNT>
+    double WalkExternal(int node, int player, const Deal &deal, std::span<double> scratch,
+                        Rng &rng, WalkCounts &counts);
+
+    // Outcome-sampling CFR: walk a single path, sampled with exploration at `player`'s
+    // decisions, and return an importance-weighted estimate of the node's value.
+    // sample_reach is the probability that sampling reached this node.
+    template<bool COUNT>
+    double WalkOutcome(int node, int player, const Deal &deal, std::span<double> scratch,
+                       Rng &rng, double reach, double opponent_reach, double sample_reach,
+                       WalkCounts &counts);
+
+    // The value of a terminal node to `player` for one deal.
+    [[nodiscard]] double GetTerminalValue(const PreflopTree::TreeNode &node, int player,
+                                          const Deal &deal) const;
+
+    /**
+     * Walk the subtree rooted at `node` with `player` playing a best response to the opponent's
+     * average strategy, and set the value of each of their hand classes.
+     * @param node the index of the node in the tree
+     * @param player the best-responding player
+     * @param scratch as in Walk
+     * @param opponent_reach the probability of each of the opponent's hand classes reaching
+     *                       this node
+     * @param values set to the best response value of each hand class to `player`, weighted by
+     *               the opponent's reach
+     */
+    void WalkBestResponse(int node, int player, std::span<double> scratch,
+                          std::span<const double> opponent_reach, std::span<double> values) const;
+
+    // Set the value to `player` of each of their hand classes at a terminal node.
+    void GetTerminalValues(const PreflopTree::TreeNode &node, int player,
+                           std::span<const double> opponent_reach, std::span<double> values) const;
+
 public:
     /**
      * Constructor for PreflopSolver.
@@ -31,11 +315,13 @@ public:
      *                              realize
      * @param p1_action_space array of PreflopAction's defining the action space for player 1
      * @param p2_action_space array of PreflopAction's defining the action space for player 2
+     * @param options storage, threading and sampling settings
      */
     PreflopSolver(double p1_starting_stack_depth, double p2_starting_stack_depth, int p1_position,
                   int p2_position, int num_max_raises, double p1_equity_multiplier,
                   std::vector<std::shared_ptr<PreflopAction> > p1_action_space,
-                  std::vector<std::shared_ptr<PreflopAction> > p2_action_space);
+                  std::vector<std::shared_ptr<PreflopAction> > p2_action_space,
+                  const SolverOptions &options = {});
 
     /**
      * Train the solver for a given number of iterations.
@@ -45,11 +331,104 @@ public:
     void train(int num_iterations, bool output = false);
 
     /**
-     * Returns the solution.
+     * Train the solver until a stopping rule is met. The limits are checked every
+     * check_interval iterations.
+     * @param stop the limits; at least one must be set
+     * @param output whether to output training logs
+     * @return the number of iterations trained
+     */
+    int train(const StoppingRule &stop, bool output = false);
+
+    /**
+     * Returns how much `player` wins by playing a best response to the opponent's average
+     * strategy, the strategy get_range returns. Subtrees are walked in parallel.
+     * @param player the best-responding player
+     * @return the expected value to `player`, in big blinds per hand
+     */
+    [[nodiscard]] double get_best_response_value(int player) const;
+
+    /**
+     * Returns how much regret-based pruning has skipped.
+     * @return the counts, all 0 if pruning is off
+     */
+    [[nodiscard]] PruningStats get_pruning_stats() const;
+
+    /**
+     * Returns the exploitability of the average strategies: the mean of what each player wins
+     * by best-responding to the other. It is 0 exactly at an equilibrium.
+     * @return the exploitability, in big blinds per hand
+     */
+    [[nodiscard]] double get_exploitability() const;
+
+    /**
+     * Save the training state, so that training can be resumed from it later.
+     * @param path the file to write
+     */
+    void save_checkpoint(const std::string &path) const;
+
+    /**
+     * Restore the training state from a checkpoint, replacing the current one. Training then
+     * continues exactly as if it had never stopped, except that pruned actions are walked
+     * again from the start.
+     * @param path the checkpoint; throws std::invalid_argument if it was saved by a solver with
+     *             a different game, tree or precision
+     */
+    void resume(const std::string &path);
+
+    /**
+     * Start from a solution of a similar game, e.g. a neighbour in a sweep over stack depths,
+     * instead of from uniform strategies. Its regrets and strategy sums are mapped onto this
+     * solver's tree by walking both from the root and matching each action to the prior's
+     * action of the same kind, the closest in size if there are several; actions with no match
+     * and their subtrees start from scratch. Replaces the current training state, the count of
+     * iterations done included, so training starts over from the prior.
+     * @param prior the solver to start from; its tree and precision may differ
+     * @param weight the number of this solver's iterations the prior counts as
+     */
+    void warm_start(const PreflopSolver &prior, double weight = 10);
+
+    /**
+     * Start from a checkpoint of a similar game, as above.
+     * @param path the checkpoint
+     * @param weight the number of this solver's iterations the prior counts as
+     */
+    void warm_start(const std::string &path, double weight = 10);
+
+    /**
+     * Wait until the checkpoints queued by training are written. If one couldn't be, its
+     * exception is rethrown here.
+     */
+    void wait_for_checkpoints();
+
+    /**
+     * Returns the number of iterations trained, resumed ones included.
+     * @return the number of iterations
+     */
+    [[nodiscard]] int64_t get_num_iterations() const;
+
+    /**
+     * Returns the memory used by the solver's regrets and strategy sums.
+     * @return the footprint of the information set storage, in bytes
+     */
+    [[nodiscard]] size_t get_memory_usage() const;
+
+    /**
+     * Returns the solution at the first decision of `player`: the root for the player who acts
+     * first, and otherwise the response to the opponent's first legal action that doesn't end the
+     * hand.
      * @param player the player whose strategy to return
      * @return a Range object representing the current strategy of the solver
      */
     [[nodiscard]] Range get_range(int player) const;
+
+    /**
+     * Returns the solution for `player` after the actions in `history`.
+     * @param player the player whose strategy to return
+     * @param history the actions played from the start of the hand; `player` must act next
+     * @return a Range object representing the average strategy at that node
+     */
+    [[nodiscard]] Range get_range(
+        int player, const std::vector<std::shared_ptr<PreflopAction> > &history) const;
 };
 
 
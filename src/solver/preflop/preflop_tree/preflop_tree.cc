@@ -0,0 +1,87 @@
+#include "solver/preflop/preflop_tree/preflop_tree.h"
+#include <algorithm>
+#include <stdexcept>
+
+PreflopTree::PreflopTree(const GameState &root,
+                         std::vector<std::shared_ptr<PreflopAction> > p1_action_space,
+                         std::vector<std::shared_ptr<PreflopAction> > p2_action_space)
+    : p1_action_space(std::move(p1_action_space)), p2_action_space(std::move(p2_action_space)) {
+    if (this->p1_action_space.size() > UINT8_MAX || this->p2_action_space.size() > UINT8_MAX)
+        throw std::invalid_argument("action space is too large");
+
+    Build(root, 0);
+    nodes.shrink_to_fit();
+    children.shrink_to_fit();
+    action_indices.shrink_to_fit();
+}
+
+int PreflopTree::Build(const GameState &state, const int depth) {
+    const int index = GetNumNodes();
+    const auto [p1_bet, p2_bet] = state.GetTotalBets();
+    nodes.push_back({p1_bet, p2_bet, 0, -1, static_cast<int>(children.size()), 0, 1,
+                     NodeType::DECISION, false});
+    max_depth = std::max(max_depth, depth);
+
+    if (state.IsTerminal()) {
+        TreeNode &node = nodes[index];
+        if (dynamic_cast<const Fold *>(state.history.back().get())) {
+            // the player to move is the one who didn't fold
+            node.type = NodeType::FOLD;
+            node.player = 3 - state.player_to_move;
+        } else {
+            node.type = NodeType::SHOWDOWN;
+            node.all_in = std::max(p1_bet, p2_bet) >= state.GetEffectiveStack();
+        }
+        return index;
+    }
+
+    const auto &action_space = state.player_to_move == 1 ? p1_action_space : p2_action_space;
+    std::vector<int> legal;
+    for (size_t a = 0; a < action_space.size(); ++a)
+        if (action_space[a]->IsLegal(state))
+            legal.push_back(static_cast<int>(a));
+    if (legal.empty())
+        throw std::invalid_argument("action space leaves a non-terminal state with no actions");
+
+    nodes[index].player = state.player_to_move;
+    nodes[index].decision = num_decisions++;
+    nodes[index].num_children = static_cast<int>(legal.size());
+    max_num_actions = std::max(max_num_actions, static_cast<int>(legal.size()));
+
+    // reserve this node's edges before the subtrees add theirs
+    const int first_child = nodes[index].first_child;
+    children.resize(children.size() + legal.size());
+    action_indices.resize(children.size());
+    for (size_t a = 0; a < legal.size(); ++a) {
+        const int child = Build(state.GetNextGameState(action_space[legal[a]]), depth + 1);
+        children[first_child + a] = child;
+        action_indices[first_child + a] = static_cast<uint8_t>(legal[a]);
+    }
+    nodes[index].subtree_size = GetNumNodes() - index;
+
+    return index;
+}
+
+const std::shared_ptr<PreflopAction> &PreflopTree::GetAction(const int node, const int a) const {
+    const auto &action_space = nodes[node].player == 1 ? p1_action_space : p2_action_space;
+    return action_space[action_indices[nodes[node].first_child + a]];
+}
+
+int PreflopTree::FindNode(const std::vector<std::shared_ptr<PreflopAction> > &history) const {
+    int node = 0;
+    for (const auto &action: history) {
+        if (nodes[node].type != NodeType::DECISION)
+            return -1;
+
+        int next = -1;
+        for (int a = 0; a < nodes[node].num_children && next < 0; ++a) {
+            const auto &legal = GetAction(node, a);
+            if (legal == action || legal->Hash() == action->Hash())
+                next = children[nodes[node].first_child + a];
+        }
+        if (next < 0)
+            return -1;
+        node = next;
+    }
+    return node;
+}
@@ -0,0 +1,144 @@
+#ifndef PREFLOP_TREE_H
+#define PREFLOP_TREE_H
+
+#include "solver/preflop/game_state/game_state.h"
+#include "solver/preflop/preflop_action/preflop_action.h"
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+/**
+ * The whole preflop betting tree, built once from the players' action spaces and stored flat: the
+ * nodes sit in one array in depth-first order, each with its bets inline, and refer to their
+ * children by index. Legal actions are worked out with GameState while building and never again,
+ * so a traversal only reads the arrays. A node's first child is the node right after it.
+ */
+class PreflopTree {
+public:
+    enum class NodeType : uint8_t {
+        DECISION,
+        FOLD,
+        SHOWDOWN
+    };
+
+    struct TreeNode {
+        // total amount each player has put in, blinds included
+        double p1_bet, p2_bet;
+        // at a decision the player to act, at a fold the player who folded, and 0 at a showdown
+        int player;
+        // index among the decision nodes in depth-first order, or -1 at a terminal node
+        int decision;
+        // the children are children[first_child, first_child + num_children), reached by the
+        // actions with the same positions in action_indices
+        int first_child, num_children;
+        // the number of nodes in the subtree rooted here, this one included
+        int subtree_size;
+        NodeType type;
+        // whether a showdown is all-in, so that there's no postflop play left
+        bool all_in;
+    };
+
+private:
+    std::vector<std::shared_ptr<PreflopAction> > p1_action_space, p2_action_space;
+    std::vector<TreeNode> nodes;
+    std::vector<int> children;
+    // index of each edge's action in the action space of the player who takes it
+    std::vector<uint8_t> action_indices;
+    int num_decisions = 0, max_depth = 0, max_num_actions = 0;
+
+    // Add the subtree rooted at state, depth actions from the root, and return its index.
+    int Build(const GameState &state, int depth);
+
+public:
+    /**
+     * Build the tree.
+     * @param root the state before the first action
+     * @param p1_action_space the actions player 1 may take, where legal
+     * @param p2_action_space the actions player 2 may take, where legal
+     */
+    PreflopTree(const GameState &root,
+                std::vector<std::shared_ptr<PreflopAction> > p1_action_space,
+                std::vector<std::shared_ptr<PreflopAction> > p2_action_space);
+
+    /**
+     * Returns the number of nodes.
+     * @return the number of nodes, terminal ones included
+     */
+    [[nodiscard]] int GetNumNodes() const;
+
+    /**
+     * Returns the number of decision nodes.
+     * @return one more than the largest TreeNode::decision
+     */
+    [[nodiscard]] int GetNumDecisions() const;
+
+    /**
+     * Returns the length of the longest history.
+     * @return the depth of the deepest node, with the root at depth 0
+     */
+    [[nodiscard]] int GetMaxDepth() const;
+
+    /**
+     * Returns the largest number of actions at any node.
+     * @return the most children any node has
+     */
+    [[nodiscard]] int GetMaxNumActions() const;
+
+    /**
+     * Returns a node. The root is node 0.
+     * @param node the index of the node
+     * @return the node
+     */
+    [[nodiscard]] const TreeNode &GetNode(int node) const;
+
+    /**
+     * Returns the children of a node.
+     * @param node the index of the node
+     * @return the indices of its children, in the order of the action space
+     */
+    [[nodiscard]] std::span<const int> GetChildren(int node) const;
+
+    /**
+     * Returns the action leading to a child of a decision node.
+     * @param node the index of the node
+     * @param a the position of the action among the node's children
+     * @return the action, as given in the action space
+     */
+    [[nodiscard]] const std::shared_ptr<PreflopAction> &GetAction(int node, int a) const;
+
+    /**
+     * Returns the node reached from the root by a history. Actions are matched by Hash, so they
+     * need not be the objects in the action spaces.
+     * @param history the actions played from the start of the hand
+     * @return the index of the node, or -1 if the history isn't in the tree
+     */
+    [[nodiscard]] int FindNode(const std::vector<std::shared_ptr<PreflopAction> > &history) const;
+};
+
+inline int PreflopTree::GetNumNodes() const {
+    return static_cast<int>(nodes.size());
+}
+
+inline int PreflopTree::GetNumDecisions() const {
+    return num_decisions;
+}
+
+inline int PreflopTree::GetMaxDepth() const {
+    return max_depth;
+}
+
+inline int PreflopTree::GetMaxNumActions() const {
+    return max_num_actions;
+}
+
+inline const PreflopTree::TreeNode &PreflopTree::GetNode(const int node) const {
+    return nodes[node];
+}
+
+inline std::span<const int> PreflopTree::GetChildren(const int node) const {
+    return {children.data() + nodes[node].first_child,
+            static_cast<size_t>(nodes[node].num_children)};
+}
+
+#endif //PREFLOP_TREE_H
@@ -0,0 +1,52 @@
+#include "solver/preflop/telemetry/telemetry.h"
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+// Append a JSON number: the shortest decimal that reads back as the same double, or null for
+// values JSON can't represent.
+static void AppendNumber(std::string &json, const double value) {
+    if (!std::isfinite(value)) {
+        json += "null";
+        return;
+    }
+    char buffer[32];
+    const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    json.append(buffer, end);
+}
+
+std::string TrainingTelemetry::ToJson() const {
+    std::string json = "{\"iteration\":" + std::to_string(iteration);
+    json += ",\"elapsed_seconds\":";
+    AppendNumber(json, elapsed_seconds);
+    json += ",\"iterations_per_second\":";
+    AppendNumber(json, iterations_per_second);
+    json += ",\"nodes_visited\":" + std::to_string(nodes_visited);
+    json += ",\"terminal_evaluations\":" + std::to_string(terminal_evaluations);
+    json += ",\"average_positive_regret\":";
+    AppendNumber(json, average_positive_regret);
+    json += ",\"strategy_change\":";
+    AppendNumber(json, strategy_change);
+    json += ",\"max_strategy_change\":";
+    AppendNumber(json, max_strategy_change);
+    json += ",\"memory_usage\":" + std::to_string(memory_usage);
+    json += ",\"exploitability\":";
+    if (exploitability)
+        AppendNumber(json, *exploitability);
+    else
+        json += "null";
+    json += '}';
+    return json;
+}
+
+TelemetryLog::TelemetryLog(const std::string &path) : file(path, std::ios::app) {
+    if (!file)
+        throw std::runtime_error("could not open " + path);
+}
+
+void TelemetryLog::Write(const TrainingTelemetry &telemetry) {
+    file << telemetry.ToJson() << '\n';
+    file.flush();
+    if (!file)
+        throw std::runtime_error("could not write telemetry");
+}
@@ -0,0 +1,62 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+
+/**
+ * A report on the progress of training, taken between two iterations. The counts are over the
+ * solver's lifetime, the rates over the iterations since the previous report.
+ */
+struct TrainingTelemetry {
+    // iterations trained, resumed ones included
+    int64_t iteration;
+    // time spent in train, reports excluded, in seconds
+    double elapsed_seconds;
+    double iterations_per_second;
+    // nodes the training walks went through, terminal nodes included, and terminal nodes they
+    // evaluated; subtrees skipped by pruning don't count
+    int64_t nodes_visited;
+    int64_t terminal_evaluations;
+    // the largest positive regret of each information set, per deal of its hand and iteration
+    // trained, averaged over every information set; it falls towards 0 as training converges
+    double average_positive_regret;
+    // the L1 distance between the average strategy of each information set now and at the
+    // previous report, averaged over every information set, and its largest value
+    double strategy_change;
+    double max_strategy_change;
+    // the memory used by the regrets and strategy sums, in bytes
+    size_t memory_usage;
+    // exploitability of the average strategies in big blinds per hand, if measured
+    std::optional<double> exploitability;
+
+    /**
+     * Returns the report as a single-line JSON object, with the names of the fields as keys. An
+     * exploitability that wasn't measured is null.
+     * @return the JSON object, without a trailing newline
+     */
+    [[nodiscard]] std::string ToJson() const;
+};
+
+// Writes reports to a file as JSON lines, one object per report.
+class TelemetryLog {
+    std::ofstream file;
+
+public:
+    /**
+     * Open the log.
+     * @param path the file to append to; throws std::runtime_error if it can't be opened
+     */
+    explicit TelemetryLog(const std::string &path);
+
+    /**
+     * Append a report and flush it, so that it can be followed while training runs.
+     * @param telemetry the report
+     */
+    void Write(const TrainingTelemetry &telemetry);
+};
+
+#endif //TELEMETRY_H
@@ -0,0 +1,50 @@
+#include "solver/preflop/update_rule/update_rule.h"
+#include <cmath>
+#include <limits>
+
+static constexpr double INF = std::numeric_limits<double>::infinity();
+
+// t^exponent / (t^exponent + 1), which is 1 for an infinite exponent and 0 for a negative
+// infinite one.
+static double GetRegretDiscount(const double exponent, const int64_t t) {
+    if (std::isinf(exponent))
+        return exponent > 0 ? 1 : 0;
+    const double power = std::pow(static_cast<double>(t), exponent);
+    return power / (power + 1);
+}
+
+UpdateRule::UpdateRule(const double alpha, const double beta, const double gamma)
+    : alpha(alpha), beta(beta), gamma(gamma) {
+}
+
+UpdateRule UpdateRule::Vanilla() {
+    return {INF, INF, 0};
+}
+
+UpdateRule UpdateRule::CFRPlus() {
+    return {INF, -INF, 1};
+}
+
+UpdateRule UpdateRule::Linear() {
+    return {1, 1, 1};
+}
+
+UpdateRule UpdateRule::Discounted(const double alpha, const double beta, const double gamma) {
+    return {alpha, beta, gamma};
+}
+
+bool UpdateRule::Discounts() const {
+    return alpha != INF || beta != INF || gamma != 0;
+}
+
+double UpdateRule::GetPositiveRegretDiscount(const int64_t t) const {
+    return GetRegretDiscount(alpha, t);
+}
+
+double UpdateRule::GetNegativeRegretDiscount(const int64_t t) const {
+    return GetRegretDiscount(beta, t);
+}
+
+double UpdateRule::GetStrategyDiscount(const int64_t t) const {
+    return std::pow(static_cast<double>(t) / static_cast<double>(t + 1), gamma);
+}
@@ -0,0 +1,75 @@
+#ifndef UPDATE_RULE_H
+#define UPDATE_RULE_H
+
+#include <cstdint>
+
+/**
+ * How a solver weighs iterations against each other: after each iteration t, positive regrets are
+ * multiplied by t^alpha / (t^alpha + 1), negative regrets by t^beta / (t^beta + 1), and the
+ * strategy sums by (t / (t + 1))^gamma. This is Discounted CFR; plain CFR, CFR+ and linear CFR
+ * are the special cases built by the factories below. Discounting early, poor iterations away
+ * converges in a fraction of the iterations plain CFR needs.
+ */
+class UpdateRule {
+    double alpha, beta, gamma;
+
+    UpdateRule(double alpha, double beta, double gamma);
+
+public:
+    /**
+     * Plain CFR: regrets and strategies are summed over every iteration with equal weight.
+     * @return the rule
+     */
+    static UpdateRule Vanilla();
+
+    /**
+     * CFR+ (regret-matching+): negative regrets are reset to 0 after every iteration, so an action
+     * that turns good is played again right away, and iteration t's strategy has weight t.
+     * @return the rule
+     */
+    static UpdateRule CFRPlus();
+
+    /**
+     * Linear CFR: iteration t's regrets and strategy have weight t.
+     * @return the rule
+     */
+    static UpdateRule Linear();
+
+    /**
+     * Discounted CFR. The defaults are those found to work best across games.
+     * @param alpha exponent of the discount of positive regrets
+     * @param beta exponent of the discount of negative regrets
+     * @param gamma exponent of the discount of the strategy sums
+     * @return the rule
+     */
+    static UpdateRule Discounted(double alpha = 1.5, double beta = 0, double gamma = 2);
+
+    /**
+     * Returns whether the rule changes anything between iterations.
+     * @return false for plain CFR
+     */
+    [[nodiscard]] bool Discounts() const;
+
+    /**
+     * Returns the factor to multiply positive regrets by after an iteration.
+     * @param t the iteration, from 1
+     * @return the factor, in [0, 1]
+     */
+    [[nodiscard]] double GetPositiveRegretDiscount(int64_t t) const;
+
+    /**
+     * Returns the factor to multiply negative regrets by after an iteration.
+     * @param t the iteration, from 1
+     * @return the factor, in [0, 1]
+     */
+    [[nodiscard]] double GetNegativeRegretDiscount(int64_t t) const;
+
+    /**
+     * Returns the factor to multiply strategy sums by after an iteration.
+     * @param t the iteration, from 1
+     * @return the factor, in [0, 1]
+     */
+    [[nodiscard]] double GetStrategyDiscount(int64_t t) const;
+};
+
+#endif //UPDATE_RULE_H
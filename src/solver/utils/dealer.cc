@@ -0,0 +1,12 @@
+#include "solver/utils/dealer.h"
+#include <stdexcept>
+
+Dealer::Dealer(const u64 dead_mask) : deck{} {
+    for (int i = 0; i < Utils::NUM_CARDS; ++i)
+        if (!(dead_mask >> i & 1))
+            deck[size++] = static_cast<uint8_t>(i);
+}
+
+int Dealer::GetSize() const {
+    return size;
+}
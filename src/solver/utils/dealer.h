@@ -0,0 +1,73 @@
+#ifndef DEALER_H
+#define DEALER_H
+
+#include "solver/utils/rng.h"
+#include "solver/utils/utils.h"
+#include <array>
+#include <span>
+
+// Deals random cards without shuffling the whole deck: each card dealt is one step of a
+// Fisher-Yates shuffle, so dealing n cards costs n draws. The deck is never reset, since any
+// permutation of it is as good a starting point as the sorted one.
+class Dealer {
+    std::array<uint8_t, Utils::NUM_CARDS> deck;
+    int size = 0;
+
+public:
+    /**
+     * Constructor for Dealer.
+     * @param dead_mask cards (as in Utils::CardsToMask) that are never dealt
+     */
+    explicit Dealer(u64 dead_mask = 0);
+
+    /**
+     * Returns the number of cards that can be dealt.
+     * @return the number of live cards
+     */
+    [[nodiscard]] int GetSize() const;
+
+    /**
+     * Deal distinct cards, uniformly at random.
+     * @param rng the generator to draw from
+     * @param num_cards how many cards to deal
+     * @param exclude cards to skip this time only, e.g. the hole cards of a sampled hand; at
+     *                least num_cards live cards must remain
+     * @return the mask of the cards dealt
+     */
+    u64 Deal(Rng& rng, int num_cards, u64 exclude = 0);
+
+    /**
+     * Deal distinct cards, uniformly at random.
+     * @param rng the generator to draw from
+     * @param cards filled with the cards dealt
+     * @param exclude cards to skip this time only
+     */
+    void Deal(Rng& rng, std::span<u32> cards, u64 exclude = 0);
+
+private:
+    // Move a random card not in exclude to position k, among positions k onwards, and return it.
+    int DealOne(Rng& rng, int k, u64 exclude);
+};
+
+inline int Dealer::DealOne(Rng& rng, const int k, const u64 exclude) {
+    int j;
+    do {
+        j = k + static_cast<int>(rng.Below(size - k));
+    } while (exclude >> deck[j] & 1);
+    std::swap(deck[k], deck[j]);
+    return deck[k];
+}
+
+inline u64 Dealer::Deal(Rng& rng, const int num_cards, const u64 exclude) {
+    u64 dealt = 0;
+    for (int k = 0; k < num_cards; ++k)
+        dealt |= 1ULL << DealOne(rng, k, exclude);
+    return dealt;
+}
+
+inline void Dealer::Deal(Rng& rng, const std::span<u32> cards, const u64 exclude) {
+    for (size_t k = 0; k < cards.size(); ++k)
+        cards[k] = Utils::IndexToCard(DealOne(rng, static_cast<int>(k), exclude));
+}
+
+#endif //DEALER_H
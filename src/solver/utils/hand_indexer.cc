@@ -0,0 +1,244 @@
+#include "solver/utils/hand_indexer.h"
+#include <algorithm>
+#include <bit>
+#include <set>
+#include <stdexcept>
+
+HandIndexer::HandIndexer(std::vector<int> cards_per_round)
+    : cards_per_round(std::move(cards_per_round)) {
+    const int num_rounds = static_cast<int>(this->cards_per_round.size());
+    if (num_rounds < 1 || num_rounds > 4)
+        throw std::invalid_argument("hands must have 1 to 4 rounds");
+    for (const int n: this->cards_per_round) {
+        if (n < 1 || n > NUM_RANKS)
+            throw std::invalid_argument("rounds must have 1 to 13 cards");
+        num_cards += n;
+    }
+    if (num_cards > Utils::NUM_CARDS)
+        throw std::invalid_argument("too many cards");
+
+    // every way to split each round's cards between the suits, with each suit's sizes coded and
+    // the suits sorted into canonical (decreasing) order
+    std::set<std::array<u32, NUM_SUITS> > patterns;
+    std::array<u32, NUM_SUITS> codes{};
+    std::array<int, NUM_SUITS> suit_cards{};
+    auto split = [&](auto&& self, const int round, const int suit, const int left) -> void {
+        if (round == num_rounds) {
+            std::array<u32, NUM_SUITS> sorted = codes;
+            std::ranges::sort(sorted, std::greater());
+            patterns.insert(sorted);
+            return;
+        }
+        if (suit == NUM_SUITS - 1) {
+            if (suit_cards[suit] + left > NUM_RANKS) return;
+            codes[suit] += left << 4 * round;
+            suit_cards[suit] += left;
+            self(self, round + 1, 0, round + 1 < num_rounds ? this->cards_per_round[round + 1] : 0);
+            codes[suit] -= left << 4 * round;
+            suit_cards[suit] -= left;
+            return;
+        }
+        for (int n = 0; n <= left && suit_cards[suit] + n <= NUM_RANKS; ++n) {
+            codes[suit] += n << 4 * round;
+            suit_cards[suit] += n;
+            self(self, round, suit + 1, left - n);
+            codes[suit] -= n << 4 * round;
+            suit_cards[suit] -= n;
+        }
+    };
+    split(split, 0, 0, this->cards_per_round[0]);
+
+    for (const std::array<u32, NUM_SUITS>& pattern: patterns) {
+        Configuration configuration{pattern, {}, {}, size, 1};
+        u64 key = 0;
+        for (int p = 0; p < NUM_SUITS; ++p) {
+            configuration.suit_sizes[p] = SuitSize(pattern[p]);
+            key = key << 16 | pattern[p];
+        }
+        for (int begin = 0, end; begin < NUM_SUITS; begin = end) {
+            for (end = begin; end < NUM_SUITS && pattern[end] == pattern[begin]; ++end) {
+            }
+            configuration.groups.emplace_back(begin, end);
+            const int g = end - begin;
+            configuration.size *= Choose(configuration.suit_sizes[begin] + g - 1, g);
+        }
+
+        configuration_of[key] = static_cast<int>(configurations.size());
+        size += configuration.size;
+        configurations.push_back(std::move(configuration));
+    }
+}
+
+HandIndexer HandIndexer::Preflop() {
+    return HandIndexer({2});
+}
+
+HandIndexer HandIndexer::Flop() {
+    return HandIndexer({2, 3});
+}
+
+HandIndexer HandIndexer::Turn() {
+    return HandIndexer({2, 3, 1});
+}
+
+HandIndexer HandIndexer::River() {
+    return HandIndexer({2, 3, 1, 1});
+}
+
+u64 HandIndexer::GetSize() const {
+    return size;
+}
+
+u64 HandIndexer::Index(const std::span<const u32> cards) const {
+    if (static_cast<int>(cards.size()) != num_cards)
+        throw std::invalid_argument("wrong number of cards");
+
+    std::array<std::array<u32, 4>, NUM_SUITS> rank_sets{};
+    u64 seen = 0;
+    for (size_t round = 0, k = 0; round < cards_per_round.size(); ++round)
+        for (int n = 0; n < cards_per_round[round]; ++n, ++k) {
+            const int i = Utils::CardToIndex(cards[k]);
+            if (seen >> i & 1)
+                throw std::invalid_argument("the same card was given twice");
+            seen |= 1ULL << i;
+            rank_sets[i % 4][round] |= 1 << i / 4;
+        }
+
+    // (code, index) of each suit, sorted into canonical order
+    std::array<std::pair<u32, u64>, NUM_SUITS> suits{};
+    for (int s = 0; s < NUM_SUITS; ++s) {
+        for (size_t round = 0; round < cards_per_round.size(); ++round)
+            suits[s].first |= std::popcount(rank_sets[s][round]) << 4 * round;
+        suits[s].second = IndexSuit(std::span(rank_sets[s]).first(cards_per_round.size()));
+    }
+    std::ranges::sort(suits, [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+
+    u64 key = 0;
+    for (const auto& suit: suits)
+        key = key << 16 | suit.first;
+    const Configuration& configuration = configurations[configuration_of.at(key)];
+
+    // each group of equal suits is a multiset of suit indices, numbered in colex order
+    u64 index = 0, multiplier = 1;
+    for (auto [begin, end]: configuration.groups) {
+        u64 group_index = 0;
+        for (int i = 0; i < end - begin; ++i)
+            group_index += Choose(suits[begin + i].second + i, i + 1);
+        index += multiplier * group_index;
+        multiplier *= Choose(configuration.suit_sizes[begin] + end - begin - 1, end - begin);
+    }
+
+    return configuration.offset + index;
+}
+
+std::vector<u32> HandIndexer::Unindex(const u64 index) const {
+    if (index >= size)
+        throw std::invalid_argument("index out of range");
+
+    const auto it = std::ranges::upper_bound(configurations, index, {}, &Configuration::offset);
+    const Configuration& configuration = *(it - 1);
+
+    std::array<u64, NUM_SUITS> suit_indices{};
+    u64 rest = index - configuration.offset;
+    for (auto [begin, end]: configuration.groups) {
+        const int g = end - begin;
+        const u64 group_size = Choose(configuration.suit_sizes[begin] + g - 1, g);
+        u64 group_index = rest % group_size;
+        rest /= group_size;
+
+        // undo the colex numbering: the largest w with C(w, i + 1) <= what's left
+        for (int i = g - 1; i >= 0; --i) {
+            u64 low = i, high = configuration.suit_sizes[begin] - 1 + i;
+            while (low < high) {
+                const u64 mid = (low + high + 1) / 2;
+                if (Choose(mid, i + 1) <= group_index) low = mid;
+                else high = mid - 1;
+            }
+            group_index -= Choose(low, i + 1);
+            suit_indices[begin + i] = low - i;
+        }
+    }
+
+    std::vector<std::vector<u32> > rounds(cards_per_round.size());
+    for (int s = 0; s < NUM_SUITS; ++s) {
+        std::array<u32, 4> rank_sets{};
+        UnindexSuit(suit_indices[s], configuration.suit_codes[s],
+                    std::span(rank_sets).first(cards_per_round.size()));
+        for (size_t round = 0; round < cards_per_round.size(); ++round)
+            for (u32 set = rank_sets[round]; set; set &= set - 1)
+                rounds[round].push_back(Utils::IndexToCard(4 * std::countr_zero(set) + s));
+    }
+
+    std::vector<u32> cards;
+    for (std::vector<u32>& round: rounds) {
+        std::ranges::sort(round, {}, Utils::CardToIndex);
+        cards.insert(cards.end(), round.begin(), round.end());
+    }
+    return cards;
+}
+
+u64 HandIndexer::IndexSuit(const std::span<const u32> rank_sets) const {
+    u64 index = 0, multiplier = 1;
+    u32 used = 0;
+    for (const u32 set: rank_sets) {
+        // colex index of the set among the ranks not used in earlier rounds
+        u64 set_index = 0;
+        int i = 0;
+        for (u32 rest = set; rest; rest &= rest - 1, ++i) {
+            const int rank = std::countr_zero(rest);
+            set_index += Choose(rank - std::popcount(used & ((1u << rank) - 1)), i + 1);
+        }
+        index += multiplier * set_index;
+        multiplier *= Choose(NUM_RANKS - std::popcount(used), std::popcount(set));
+        used |= set;
+    }
+    return index;
+}
+
+void HandIndexer::UnindexSuit(u64 index, const u32 code, const std::span<u32> rank_sets) const {
+    u32 used = 0;
+    for (size_t round = 0; round < rank_sets.size(); ++round) {
+        const int k = static_cast<int>(code >> 4 * round & 15);
+        const int available = NUM_RANKS - std::popcount(used);
+        const u64 num_sets = Choose(available, k);
+        u64 set_index = index % num_sets;
+        index /= num_sets;
+
+        u32 set = 0;
+        int position = available;
+        for (int i = k - 1; i >= 0; --i) {
+            do --position;
+            while (Choose(position, i + 1) > set_index);
+            set_index -= Choose(position, i + 1);
+
+            // the position-th rank not used yet
+            int rank = -1;
+            for (int seen = -1; seen < position;)
+                seen += !(used >> ++rank & 1);
+            set |= 1u << rank;
+        }
+        rank_sets[round] = set;
+        used |= set;
+    }
+}
+
+u64 HandIndexer::SuitSize(const u32 code) const {
+    u64 num_tuples = 1;
+    int used = 0;
+    for (size_t round = 0; round < cards_per_round.size(); ++round) {
+        const int k = static_cast<int>(code >> 4 * round & 15);
+        num_tuples *= Choose(NUM_RANKS - used, k);
+        used += k;
+    }
+    return num_tuples;
+}
+
+u64 HandIndexer::Choose(const u64 n, const int k) {
+    if (k < 0 || static_cast<u64>(k) > n) return 0;
+    unsigned __int128 result = 1;
+    for (int i = 1; i <= k; ++i)
+        result = result * (n - k + i) / i;
+    return static_cast<u64>(result);
+}
@@ -0,0 +1,95 @@
+#ifndef HAND_INDEXER_H
+#define HAND_INDEXER_H
+
+#include "solver/utils/utils.h"
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+// Maps hands to dense indices up to suit isomorphism: two hands get the same index exactly when
+// relabelling suits turns one into the other (e.g. AhKh on Qh7d2d and AsKs on Qs7c2c). A hand is
+// dealt in rounds (hole cards, flop, turn, river) and cards within a round are unordered. Solvers
+// and caches can then keep one entry per class, up to 24x fewer than per raw hand.
+//
+// The scheme follows Waugh's "A Fast and Optimal Hand Isomorphism Algorithm". The cards of each
+// suit form a tuple of rank sets, one per round, which is numbered within the tuples of the same
+// sizes. Sorting the suits by (sizes, number) gives a canonical order, and suits with the same
+// sizes are interchangeable, so they are numbered as a multiset. The indices of each pattern of
+// sizes across the four suits take a contiguous block.
+//
+// Sizes: preflop 169, flop 1286792, turn 55190538, river 2428287420. Where the order of the board
+// cards doesn't matter (e.g. showdown equity), indexing the board as one round is smaller:
+// {2, 4} has 13960050 classes and {2, 5} has 123156254.
+class HandIndexer {
+    static constexpr int NUM_SUITS = 4;
+    static constexpr int NUM_RANKS = 13;
+
+    // cards dealt in each round
+    std::vector<int> cards_per_round;
+    int num_cards = 0;
+
+    // A pattern of sizes across the four suits, in canonical order. Suits with equal sizes form
+    // a group; a suit's sizes are coded 4 bits per round.
+    struct Configuration {
+        std::array<u32, NUM_SUITS> suit_codes;
+        // the number of rank-set tuples of each suit's sizes
+        std::array<u64, NUM_SUITS> suit_sizes;
+        // groups of equal suits: [begin, end) positions in the canonical order
+        std::vector<std::pair<int, int> > groups;
+        u64 offset, size;
+    };
+    std::vector<Configuration> configurations;
+    std::unordered_map<u64, int> configuration_of;
+    u64 size = 0;
+
+public:
+    /**
+     * Constructor for HandIndexer.
+     * @param cards_per_round the number of cards dealt in each round, e.g. {2, 3} for hole cards
+     *                        and a flop
+     */
+    explicit HandIndexer(std::vector<int> cards_per_round);
+
+    // Indexers for hole cards alone and with a flop, turn or river, each street its own round.
+    static HandIndexer Preflop();
+    static HandIndexer Flop();
+    static HandIndexer Turn();
+    static HandIndexer River();
+
+    /**
+     * Returns the number of classes.
+     * @return one more than the largest index
+     */
+    [[nodiscard]] u64 GetSize() const;
+
+    /**
+     * Returns the index of a hand. Throws std::invalid_argument if the cards repeat or there are
+     * the wrong number of them.
+     * @param cards the cards of every round in order, e.g. the hole cards then the flop
+     * @return the index in [0, GetSize())
+     */
+    [[nodiscard]] u64 Index(std::span<const u32> cards) const;
+
+    /**
+     * Returns the canonical hand of a class, which Index maps back to index.
+     * @param index the index, in [0, GetSize())
+     * @return the cards of every round in order, each round sorted by card index
+     */
+    [[nodiscard]] std::vector<u32> Unindex(u64 index) const;
+
+private:
+    // Number the rank sets of one suit (one 13-bit mask per round) among the tuples of sets of
+    // the same sizes.
+    [[nodiscard]] u64 IndexSuit(std::span<const u32> rank_sets) const;
+
+    // Inverse of IndexSuit for a suit with sizes code.
+    void UnindexSuit(u64 index, u32 code, std::span<u32> rank_sets) const;
+
+    // Returns the number of rank-set tuples with the sizes in code.
+    [[nodiscard]] u64 SuitSize(u32 code) const;
+
+    // n choose k, exact while the result fits in 64 bits.
+    static u64 Choose(u64 n, int k);
+};
+
+#endif //HAND_INDEXER_H
@@ -0,0 +1,56 @@
+#include "solver/utils/mapped_file.h"
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+MappedFile::MappedFile(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("can't open " + path);
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("can't stat " + path);
+    }
+    size = static_cast<size_t>(info.st_size);
+
+    // an empty file can't be mapped; leave data null
+    if (size > 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("can't map " + path);
+        }
+        data = static_cast<const std::byte*>(mapping);
+    }
+
+    // the mapping keeps the file alive
+    close(fd);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)) {
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        if (data)
+            munmap(const_cast<std::byte*>(data), size);
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    if (data)
+        munmap(const_cast<std::byte*>(data), size);
+}
+
+std::span<const std::byte> MappedFile::GetData() const {
+    return {data, size};
+}
@@ -0,0 +1,36 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+// A file mapped read-only into memory. The pages are loaded on first touch and shared between
+// every process that maps the same file, so large precomputed tables cost nothing to open.
+class MappedFile {
+    const std::byte* data = nullptr;
+    size_t size = 0;
+
+public:
+    /**
+     * Map a file.
+     * @param path the file to map; throws std::runtime_error if it can't be opened or mapped
+     */
+    explicit MappedFile(const std::string& path);
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile();
+
+    /**
+     * Returns the contents of the file. Stays valid (at the same address) until this MappedFile
+     * is destroyed, even if it is moved.
+     * @return the bytes of the file
+     */
+    [[nodiscard]] std::span<const std::byte> GetData() const;
+};
+
+#endif //MAPPED_FILE_H
@@ -0,0 +1,122 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+// xoshiro256**, a small and fast generator with 256 bits of state, seeded through SplitMix64 so
+// that any 64-bit seed gives a well-mixed state. Split hands out independent streams 2^128 draws
+// apart, so parallel code can give each thread (or each batch of work) its own stream and still
+// get the same results for the same seed. Also a UniformRandomBitGenerator, so it works with the
+// standard distributions and algorithms.
+class Rng {
+    std::array<uint64_t, 4> state;
+
+public:
+    using result_type = uint64_t;
+
+    /**
+     * Constructor for Rng.
+     * @param seed any value; equal seeds give equal sequences
+     */
+    explicit Rng(uint64_t seed);
+
+    /**
+     * Returns the next 64 random bits.
+     * @return a uniform 64-bit value
+     */
+    uint64_t Next();
+
+    /**
+     * Returns a uniform integer in [0, n), without modulo bias.
+     * @param n the bound, at least 1
+     * @return the integer
+     */
+    uint32_t Below(uint32_t n);
+
+    /**
+     * Returns a uniform double in [0, 1).
+     * @return the double
+     */
+    double NextDouble();
+
+    /**
+     * Returns a generator for a new stream and moves this one past it: the returned generator
+     * starts where this one was, and this one jumps 2^128 draws ahead. Successive calls give
+     * non-overlapping streams.
+     * @return the generator for the new stream
+     */
+    Rng Split();
+
+    uint64_t operator()() { return Next(); }
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return std::numeric_limits<uint64_t>::max(); }
+
+private:
+    // Advance the state by 2^128 draws.
+    void Jump();
+};
+
+inline Rng::Rng(uint64_t seed) : state{} {
+    // SplitMix64
+    for (uint64_t& word: state) {
+        seed += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = seed;
+        z = (z ^ z >> 30) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ z >> 27) * 0x94d049bb133111ebULL;
+        word = z ^ z >> 31;
+    }
+}
+
+inline uint64_t Rng::Next() {
+    const uint64_t result = std::rotl(state[1] * 5, 7) * 9;
+    const uint64_t t = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = std::rotl(state[3], 45);
+    return result;
+}
+
+inline uint32_t Rng::Below(const uint32_t n) {
+    // Lemire's multiply-and-shift, rejecting the few low products that would bias it
+    uint64_t product = (Next() >> 32) * n;
+    if (static_cast<uint32_t>(product) < n) {
+        const uint32_t threshold = -n % n;
+        while (static_cast<uint32_t>(product) < threshold)
+            product = (Next() >> 32) * n;
+    }
+    return static_cast<uint32_t>(product >> 32);
+}
+
+inline double Rng::NextDouble() {
+    return static_cast<double>(Next() >> 11) * 0x1.0p-53;
+}
+
+inline Rng Rng::Split() {
+    Rng stream = *this;
+    Jump();
+    return stream;
+}
+
+inline void Rng::Jump() {
+    static constexpr std::array<uint64_t, 4> JUMP = {
+        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+    };
+
+    std::array<uint64_t, 4> jumped{};
+    for (const uint64_t word: JUMP)
+        for (int b = 0; b < 64; ++b) {
+            if (word >> b & 1)
+                for (int k = 0; k < 4; ++k)
+                    jumped[k] ^= state[k];
+            Next();
+        }
+    state = jumped;
+}
+
+#endif //RNG_H
@@ -0,0 +1,218 @@
+#include "solver/utils/task_scheduler.h"
+#include <algorithm>
+#include <utility>
+
+// Smallest chunk a ScratchArena allocates, in doubles.
+static constexpr size_t MIN_CHUNK = 1 << 16;
+
+// Times a thread with nothing to run looks again, yielding in between, before it sleeps.
+static constexpr int SPIN_LIMIT = 1 << 10;
+
+// The scheduler the calling thread is running tasks of, and its index there.
+static thread_local const TaskScheduler* current_scheduler = nullptr;
+static thread_local int current_thread = -1;
+
+std::span<double> ScratchArena::Allocate(const size_t n) {
+    while (chunk < chunks.size() && used + n > chunks[chunk].size()) {
+        ++chunk;
+        used = 0;
+    }
+    if (chunk == chunks.size())
+        chunks.emplace_back(std::max(n, MIN_CHUNK));
+
+    const std::span<double> buffer(chunks[chunk].data() + used, n);
+    used += n;
+    return buffer;
+}
+
+template<typename F>
+void TaskScheduler::RunUntil(const int thread, const F &done) {
+    for (int idle = 0; !done();) {
+        // read before looking for a task, so that a task spawned after the look changes it and
+        // a sleep below can't miss it
+        const size_t spawned = num_spawned.load();
+        if (RunOne(thread)) {
+            idle = 0;
+        } else if (++idle < SPIN_LIMIT) {
+            std::this_thread::yield();
+        } else {
+            // whoever spawns a task or changes done() next sees num_sleeping and wakes this
+            // thread, or else this thread sees their change before it sleeps
+            std::unique_lock lock(mutex);
+            num_sleeping.fetch_add(1);
+            task_ready.wait(lock, [&] { return num_spawned.load() != spawned || done(); });
+            num_sleeping.fetch_sub(1);
+            idle = 0;
+        }
+    }
+}
+
+TaskScheduler::TaskGroup::TaskGroup(TaskScheduler& scheduler) : scheduler(scheduler) {
+}
+
+TaskScheduler::TaskGroup::~TaskGroup() {
+    try {
+        Wait();
+    } catch (...) {
+        // the error was already reported, or the group is being unwound by another one
+    }
+}
+
+void TaskScheduler::TaskGroup::Spawn(std::function<void(int thread)> f) {
+    const int thread = scheduler.GetCurrentThread();
+    if (thread < 0) {
+        f(0);
+        return;
+    }
+
+    pending.fetch_add(1, std::memory_order_relaxed);
+    Worker& worker = *scheduler.workers[thread];
+    {
+        std::lock_guard lock(worker.mutex);
+        worker.tasks.push_back({std::move(f), this});
+    }
+    scheduler.num_spawned.fetch_add(1);
+    if (scheduler.num_sleeping.load() > 0)
+        scheduler.WakeSleepers();
+}
+
+void TaskScheduler::TaskGroup::Wait() {
+    const int thread = scheduler.GetCurrentThread();
+    if (pending.load(std::memory_order_acquire) > 0)
+        scheduler.RunUntil(thread, [this] { return pending.load() == 0; });
+
+    std::lock_guard lock(error_mutex);
+    if (error)
+        std::rethrow_exception(std::exchange(error, nullptr));
+}
+
+TaskScheduler::TaskScheduler(const int num_threads) {
+    const int n = num_threads > 0
+                      ? num_threads
+                      : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int thread = 0; thread < n; ++thread)
+        workers.push_back(std::make_unique<Worker>());
+    for (int thread = 1; thread < n; ++thread)
+        threads.emplace_back(&TaskScheduler::WorkerLoop, this, thread);
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    work_ready.notify_all();
+    for (std::thread& thread: threads)
+        thread.join();
+}
+
+void TaskScheduler::Run(const std::function<void(int thread)>& f) {
+    std::lock_guard run_lock(run_mutex);
+    {
+        std::lock_guard lock(mutex);
+        running = true;
+        ++generation;
+    }
+    work_ready.notify_all();
+
+    const TaskScheduler* const outer_scheduler = current_scheduler;
+    const int outer_thread = current_thread;
+    current_scheduler = this;
+    current_thread = 0;
+    try {
+        f(0);
+    } catch (...) {
+        current_scheduler = outer_scheduler;
+        current_thread = outer_thread;
+        running = false;
+        WakeSleepers();
+        throw;
+    }
+    current_scheduler = outer_scheduler;
+    current_thread = outer_thread;
+    running = false;
+    WakeSleepers();
+}
+
+void TaskScheduler::ParallelFor(const size_t num_tasks,
+                                const std::function<void(size_t task, int thread)>& f) {
+    Run([&](const int thread) { Split(0, num_tasks, f, thread); });
+}
+
+void TaskScheduler::Split(size_t begin, size_t end, const std::function<void(size_t, int)>& f,
+                          const int thread) {
+    TaskGroup group(*this);
+    while (end - begin > 1) {
+        const size_t middle = begin + (end - begin) / 2;
+        group.Spawn([this, middle, end, &f](const int thief) { Split(middle, end, f, thief); });
+        end = middle;
+    }
+    if (begin < end)
+        f(begin, thread);
+    group.Wait();
+}
+
+void TaskScheduler::WorkerLoop(const int thread) {
+    current_scheduler = this;
+    current_thread = thread;
+
+    size_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            work_ready.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        RunUntil(thread, [this] { return !running.load(); });
+    }
+}
+
+bool TaskScheduler::RunOne(const int thread) {
+    Task task;
+    bool found = false;
+    {
+        Worker& own = *workers[thread];
+        std::lock_guard lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            found = true;
+        }
+    }
+    for (int i = 1; i < GetNumThreads() && !found; ++i) {
+        Worker& victim = *workers[(thread + i) % GetNumThreads()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            found = true;
+        }
+    }
+    if (!found)
+        return false;
+
+    try {
+        task.run(thread);
+    } catch (...) {
+        std::lock_guard lock(task.group->error_mutex);
+        if (!task.group->error) task.group->error = std::current_exception();
+    }
+    // the group may be destroyed as soon as this lands, so it must be the last access to it
+    if (task.group->pending.fetch_sub(1) == 1 && num_sleeping.load() > 0)
+        WakeSleepers();
+    return true;
+}
+
+void TaskScheduler::WakeSleepers() {
+    // taking the mutex orders this after a sleeper's last check of its condition
+    {
+        std::lock_guard lock(mutex);
+    }
+    task_ready.notify_all();
+}
+
+int TaskScheduler::GetCurrentThread() const {
+    return current_scheduler == this ? current_thread : -1;
+}
@@ -0,0 +1,208 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+// Scratch memory for one thread, handed out and given back in stack order. A task takes what it
+// needs on entry and releases it on exit, so tasks nested on the same thread (a task run while
+// another waits) stack their buffers without ever allocating once the arena has grown.
+class ScratchArena {
+    std::vector<std::vector<double>> chunks;
+    size_t chunk = 0, used = 0;
+
+public:
+    // A point to release back to.
+    struct Mark {
+        size_t chunk, used;
+    };
+
+    /**
+     * Returns n doubles, uninitialized, valid until released.
+     * @param n the number of doubles
+     * @return the buffer
+     */
+    [[nodiscard]] std::span<double> Allocate(size_t n);
+
+    [[nodiscard]] Mark GetMark() const;
+
+    /**
+     * Gives back everything allocated since a mark was taken.
+     * @param mark the mark
+     */
+    void Release(Mark mark);
+};
+
+/**
+ * A work-stealing scheduler for fork-join parallelism, meant for splitting a single tree
+ * traversal: a task spawns its children's subtrees as tasks, works on one itself and waits for
+ * the rest. Each thread keeps its own deque of spawned tasks and works from the newest end, so it
+ * goes depth-first and reuses warm caches, while idle threads steal from the oldest end, which
+ * holds the largest pieces of work. A thread waiting on a group runs other tasks meanwhile, so
+ * nothing blocks. A thread that finds nothing to run spins for a little while, then sleeps until
+ * a task is spawned, a group it waits on finishes or the run ends.
+ *
+ * Tasks only run inside Run or ParallelFor; outside them the workers sleep. ParallelFor serves
+ * flat data-parallel loops too, such as EquityCalculator's board enumeration.
+ */
+class TaskScheduler {
+public:
+    class TaskGroup;
+
+private:
+    struct Task {
+        std::function<void(int)> run;
+        TaskGroup* group;
+    };
+
+    // padded so that threads polling their own deque don't share a cache line
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        ScratchArena scratch;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    // serializes Run calls from different threads
+    std::mutex run_mutex;
+
+    // guards generation and stopping, and the sleep of threads with nothing to run
+    std::mutex mutex;
+    std::condition_variable work_ready, task_ready;
+    size_t generation = 0;
+    bool stopping = false;
+    std::atomic<bool> running = false;
+    // tasks spawned so far, and threads asleep on task_ready
+    std::atomic<size_t> num_spawned = 0;
+    std::atomic<int> num_sleeping = 0;
+
+public:
+    /**
+     * Tasks spawned together, to be waited on together. Waiting happens on destruction too, so
+     * tasks may safely refer to the spawner's locals.
+     */
+    class TaskGroup {
+        friend class TaskScheduler;
+
+        TaskScheduler& scheduler;
+        std::atomic<int> pending = 0;
+        std::mutex error_mutex;
+        std::exception_ptr error;
+
+    public:
+        explicit TaskGroup(TaskScheduler& scheduler);
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        ~TaskGroup();
+
+        /**
+         * Queue f(thread) on the calling thread's deque. Outside Run, f runs right away.
+         * @param f the task; thread is the index of the thread that runs it
+         */
+        void Spawn(std::function<void(int thread)> f);
+
+        /**
+         * Run tasks until every task of the group is done. If any threw, the first exception is
+         * rethrown here.
+         */
+        void Wait();
+    };
+
+    /**
+     * Start the scheduler.
+     * @param num_threads number of threads to run tasks on, counting the caller of Run; 0 means
+     *                    one per hardware thread
+     */
+    explicit TaskScheduler(int num_threads = 0);
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    ~TaskScheduler();
+
+    /**
+     * Returns the number of threads tasks run on, counting the caller of Run.
+     * @return the number of threads
+     */
+    [[nodiscard]] int GetNumThreads() const;
+
+    /**
+     * Returns a thread's scratch arena. Only that thread may use it, and only while running a
+     * task.
+     * @param thread the index of the thread
+     * @return the arena
+     */
+    [[nodiscard]] ScratchArena& GetScratch(int thread);
+
+    /**
+     * Run f on the calling thread, as thread 0, with the other threads stealing the tasks it
+     * spawns, and return once f returns. f must wait on every group it spawns.
+     * @param f the root task
+     */
+    void Run(const std::function<void(int thread)>& f);
+
+    /**
+     * Run f(task, thread) for every task in [0, num_tasks). The range is split in halves
+     * recursively, so idle threads steal large blocks of it, and f may spawn tasks of its own.
+     * thread is in [0, GetNumThreads()) and no two calls running at the same time share it, so f
+     * can keep per-thread state indexed by it. If f throws, one of its exceptions is rethrown
+     * here.
+     * @param num_tasks the number of tasks
+     * @param f the work for one task
+     */
+    void ParallelFor(size_t num_tasks, const std::function<void(size_t task, int thread)>& f);
+
+private:
+    // Body of worker thread `thread`.
+    void WorkerLoop(int thread);
+
+    // Run one task from the thread's own deque, or else one stolen from another thread's.
+    // Returns false if there was none.
+    bool RunOne(int thread);
+
+    // Run tasks until done() holds. With none to run, spin for a while, then sleep on task_ready
+    // until a task is spawned or done() may have changed.
+    template<typename F>
+    void RunUntil(int thread, const F &done);
+
+    // Wake the threads asleep on task_ready, if any.
+    void WakeSleepers();
+
+    // Run f over [begin, end), spawning the upper halves.
+    void Split(size_t begin, size_t end, const std::function<void(size_t, int)>& f, int thread);
+
+    // The index of the calling thread in this scheduler, or -1 if it's not running a task of it.
+    [[nodiscard]] int GetCurrentThread() const;
+};
+
+inline ScratchArena::Mark ScratchArena::GetMark() const {
+    return {chunk, used};
+}
+
+inline void ScratchArena::Release(const Mark mark) {
+    chunk = mark.chunk;
+    used = mark.used;
+}
+
+inline int TaskScheduler::GetNumThreads() const {
+    return static_cast<int>(workers.size());
+}
+
+inline ScratchArena& TaskScheduler::GetScratch(const int thread) {
+    return workers[thread]->scratch;
+}
+
+#endif //TASK_SCHEDULER_H
@@ -1,6 +1,8 @@
 #include "solver/eval/eval.h"
 #include "solver/utils/utils.h"
+#include "solver/utils/rng.h"
 #include "solver/preflop/preflop_solver.h"
+#include <algorithm>
 #include <iostream>
 #include <random>
 
@@ -58,6 +60,38 @@ std::string Utils::CardToString(const u32 card) {
     return std::string(1, rank_index_to_char.at(rank_index)) + suit_index_to_char.at(suit_index);
 }
 
+int Utils::ParseHandClass(const std::string &hand_class) {
+    static const std::string ranks = "23456789TJQKA";
+
+    const size_t r1 = hand_class.length() >= 2 ? ranks.find(hand_class[0]) : std::string::npos;
+    const size_t r2 = hand_class.length() >= 2 ? ranks.find(hand_class[1]) : std::string::npos;
+    if (r1 == std::string::npos || r2 == std::string::npos || hand_class.length() > 3)
+        throw std::invalid_argument("invalid hand class: " + hand_class);
+
+    const int hi = static_cast<int>(std::max(r1, r2)), lo = static_cast<int>(std::min(r1, r2));
+    if (hi == lo && hand_class.length() == 2)
+        return 13 * hi + lo;
+    if (hi != lo && hand_class.length() == 3 && hand_class[2] == 's')
+        return 13 * hi + lo;
+    if (hi != lo && hand_class.length() == 3 && hand_class[2] == 'o')
+        return 13 * lo + hi;
+    throw std::invalid_argument("invalid hand class: " + hand_class);
+}
+
+std::string Utils::HandClassToString(const int hand_class) {
+    static const std::string ranks = "23456789TJQKA";
+
+    if (hand_class < 0 || hand_class >= NUM_HAND_CLASSES)
+        throw std::invalid_argument("invalid hand class");
+    const int row = hand_class / 13, column = hand_class % 13;
+    const int hi = std::max(row, column), lo = std::min(row, column);
+
+    std::string s = {ranks[hi], ranks[lo]};
+    if (row > column) s += 's';
+    if (row < column) s += 'o';
+    return s;
+}
+
 std::vector<u32> Utils::MakeDeck() {
     std::vector<u32> deck;
     const std::string ranks = "23456789TJQKA";
@@ -71,8 +105,8 @@ std::vector<u32> Utils::MakeDeck() {
 }
 
 void Utils::Shuffle(std::vector<u32> &deck) {
-    auto rd = std::random_device();
-    auto rng = std::default_random_engine(rd());
+    // seed once per thread instead of building a random_device on every call
+    thread_local Rng rng(std::random_device{}() | static_cast<u64>(std::random_device{}()) << 32);
     std::ranges::shuffle(deck, rng);
 }
 
@@ -3,6 +3,11 @@
 
 #include "solver/eval/eval.h"
 #include "solver/preflop/preflop_solver.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <span>
+#include <utility>
 
 class Utils {
 public:
@@ -12,6 +17,9 @@ public:
 	static constexpr u32 CARD_PRIME = 63;
 	//                                             2  3  4  5  6   7   8   9   T   J   Q   K   A
 	static constexpr std::array<int, 13> PRIMES = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41};
+	static constexpr int NUM_CARDS = 52;
+	static constexpr int NUM_COMBOS = 1326;
+	static constexpr int NUM_HAND_CLASSES = 169;
 
 	// string -> card
 	// s should be of the form Rs, with R = rank, s = suit.
@@ -24,10 +32,41 @@ public:
 	// Returns string of the form Rs, with R = rank, s = suit.
 	static std::string CardToString(u32 card);
 
+	// card -> index in [0, 52), equal to 4 * rank + suit, where ranks go 2 = 0, ..., A = 12 and
+	// suits go s = 0, h = 1, d = 2, c = 3 as in ParseCard.
+	static int CardToIndex(u32 card);
+
+	// index in [0, 52) -> card
+	static u32 IndexToCard(int index);
+
+	// Return a mask with bit CardToIndex(c) set for every card c in cards.
+	static u64 CardsToMask(std::span<const u32> cards);
+
+	// Return the index in [0, 1326) of the two-card combo made of the cards with (distinct)
+	// indices i and j, in either order.
+	static int ComboIndex(int i, int j);
+
+	// combo index -> {higher card index, lower card index}
+	static std::pair<int, int> ComboToIndices(int combo);
+
+	// combo index -> starting-hand class in [0, 169), laid out as a 13x13 grid indexed by
+	// 13 * row + column with ranks 2 = 0, ..., A = 12: pairs on the diagonal, suited hands at
+	// [high rank][low rank] and offsuit hands at [low rank][high rank].
+	static int ComboToHandClass(int combo);
+
+	// Parse a hand class such as "AA", "AKs" or "76o" into its index as in ComboToHandClass.
+	static int ParseHandClass(const std::string &hand_class);
+
+	// hand class index -> string such as "AA", "AKs" or "76o"
+	static std::string HandClassToString(int hand_class);
+
+	// Return the number of combos in a hand class: 6 for pairs, 4 suited, 12 offsuit.
+	static int HandClassSize(int hand_class);
+
 	// Return an unshuffled deck, where the cards are represented by Cactus Kev
 	static std::vector<u32> MakeDeck();
 
-	// Shuffle a deck
+	// Shuffle a deck. To deal a few random cards, Dealer is much cheaper.
 	static void Shuffle(std::vector<u32> &deck);
 
 	/**
@@ -48,4 +87,45 @@ public:
 	static void HashCombine(std::size_t &seed, const std::size_t &value);
 };
 
+inline int Utils::CardToIndex(const u32 card) {
+	return 4 * std::countr_zero(card >> 16) + std::countr_zero((card & CARD_SUIT) >> 12);
+}
+
+inline u32 Utils::IndexToCard(const int index) {
+	const int rank_index = index / 4, suit_index = index % 4;
+	return 1 << (rank_index + 16) | PRIMES[rank_index] | 1 << (suit_index + 12);
+}
+
+inline u64 Utils::CardsToMask(const std::span<const u32> cards) {
+	u64 mask = 0;
+	for (const u32 card: cards)
+		mask |= 1ULL << CardToIndex(card);
+	return mask;
+}
+
+inline int Utils::ComboIndex(const int i, const int j) {
+	const int hi = std::max(i, j), lo = std::min(i, j);
+	return hi * (hi - 1) / 2 + lo;
+}
+
+inline std::pair<int, int> Utils::ComboToIndices(const int combo) {
+	// hi is the largest index with hi * (hi - 1) / 2 <= combo
+	int hi = static_cast<int>((1 + std::sqrt(1.0 + 8.0 * combo)) / 2);
+	if (hi * (hi - 1) / 2 > combo) --hi;
+	return {hi, combo - hi * (hi - 1) / 2};
+}
+
+inline int Utils::ComboToHandClass(const int combo) {
+	auto [i, j] = ComboToIndices(combo);
+	const int hi = i / 4, lo = j / 4;
+	if (i % 4 == j % 4)
+		return 13 * hi + lo;
+	return 13 * std::min(hi, lo) + std::max(hi, lo);
+}
+
+inline int Utils::HandClassSize(const int hand_class) {
+	const int row = hand_class / 13, column = hand_class % 13;
+	return row == column ? 6 : row > column ? 4 : 12;
+}
+
 #endif
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include "solver/equity/equity.h"
+#include "solver/eval/eval.h"
+#include "solver/utils/utils.h"
+#include <numeric>
+#include <vector>
+
+class TestEquity : public testing::Test {
+protected:
+    EquityCalculator calculator{4};
+};
+
+TEST_F(TestEquity, HandVsHandMatchesBruteForce) {
+    constexpr Eval eval;
+    const std::vector<u32> hand1 = Utils::ParseCards("AhKh");
+    const std::vector<u32> hand2 = Utils::ParseCards("9c9d");
+    const std::vector<u32> board = Utils::ParseCards("Qh7h2c");
+    const std::vector<u32> dead = Utils::ParseCards("3h");
+    const u64 used = Utils::CardsToMask(hand1) | Utils::CardsToMask(hand2) |
+                     Utils::CardsToMask(board) | Utils::CardsToMask(dead);
+
+    EquityResult expected;
+    for (int turn = 0; turn < Utils::NUM_CARDS; ++turn)
+        for (int river = 0; river < turn; ++river) {
+            if ((used >> turn | used >> river) & 1) continue;
+            std::vector<u32> cards1 = board, cards2 = board;
+            for (const int i: {turn, river}) {
+                cards1.push_back(Utils::IndexToCard(i));
+                cards2.push_back(Utils::IndexToCard(i));
+            }
+            cards1.insert(cards1.end(), hand1.begin(), hand1.end());
+            cards2.insert(cards2.end(), hand2.begin(), hand2.end());
+            const int rank1 = eval.GetBestHand(cards1), rank2 = eval.GetBestHand(cards2);
+            expected.win += rank1 < rank2;
+            expected.tie += rank1 == rank2;
+            expected.lose += rank1 > rank2;
+        }
+
+    const EquityResult result = calculator.HandVsHand(hand1, hand2, board, dead);
+    EXPECT_EQ(expected.win, result.win);
+    EXPECT_EQ(expected.tie, result.tie);
+    EXPECT_EQ(expected.lose, result.lose);
+}
+
+TEST_F(TestEquity, HandVsHandPreflop) {
+    const EquityResult aces = calculator.HandVsHand(Utils::ParseCards("AhAs"),
+                                                    Utils::ParseCards("KdKc"));
+    const EquityResult kings = calculator.HandVsHand(Utils::ParseCards("KdKc"),
+                                                     Utils::ParseCards("AhAs"));
+
+    EXPECT_EQ(1712304, aces.win + aces.tie + aces.lose) << "every board of 48 cards once";
+    EXPECT_EQ(aces.win, kings.lose);
+    EXPECT_EQ(aces.tie, kings.tie);
+    EXPECT_NEAR(0.8126, aces.GetEquity(), 1e-4);
+
+    EXPECT_THROW(static_cast<void>(calculator.HandVsHand(Utils::ParseCards("AhAs"),
+                                                         Utils::ParseCards("AhKc"))),
+                 std::invalid_argument);
+}
+
+TEST_F(TestEquity, RangeVsRangeMatchesHandVsHand) {
+    const std::vector<double> range1 = EquityCalculator::ParseRange("AA,KK:0.5,AKs,7c6c");
+    const std::vector<double> range2 = EquityCalculator::ParseRange("QQ,JTs:0.25,AhKd");
+    const std::vector<u32> board = Utils::ParseCards("Ks8c5d2h");
+    const std::vector<u32> dead = Utils::ParseCards("As");
+
+    const RangeEquity result = calculator.RangeVsRange(range1, range2, board, dead);
+
+    const u64 known = Utils::CardsToMask(board) | Utils::CardsToMask(dead);
+    EquityResult total;
+    for (int combo1 = 0; combo1 < Utils::NUM_COMBOS; ++combo1) {
+        auto [a, b] = Utils::ComboToIndices(combo1);
+        const u64 mask1 = 1ULL << a | 1ULL << b;
+        EquityResult expected;
+        for (int combo2 = 0; combo2 < Utils::NUM_COMBOS; ++combo2) {
+            auto [c, d] = Utils::ComboToIndices(combo2);
+            const u64 mask2 = 1ULL << c | 1ULL << d;
+            if (!range1[combo1] || !range2[combo2] || (mask1 & (mask2 | known)) || (mask2 & known))
+                continue;
+            const double weight = range1[combo1] * range2[combo2];
+            const EquityResult matchup = calculator.HandVsHand(
+                std::vector{Utils::IndexToCard(a), Utils::IndexToCard(b)},
+                std::vector{Utils::IndexToCard(c), Utils::IndexToCard(d)}, board, dead);
+            expected.win += weight * matchup.win;
+            expected.tie += weight * matchup.tie;
+            expected.lose += weight * matchup.lose;
+        }
+
+        EXPECT_NEAR(expected.win, result.combos[combo1].win, 1e-9) << "WA on combo " << combo1;
+        EXPECT_NEAR(expected.tie, result.combos[combo1].tie, 1e-9) << "WA on combo " << combo1;
+        EXPECT_NEAR(expected.lose, result.combos[combo1].lose, 1e-9) << "WA on combo " << combo1;
+        total += expected;
+    }
+    EXPECT_NEAR(total.GetEquity(), result.total.GetEquity(), 1e-12);
+}
+
+TEST_F(TestEquity, MonteCarloHandVsHand) {
+    const std::vector<u32> hand1 = Utils::ParseCards("AhKh"), hand2 = Utils::ParseCards("9c9d");
+    const std::vector<u32> board = Utils::ParseCards("Qh7h2c");
+    const double exact = calculator.HandVsHand(hand1, hand2, board).GetEquity();
+
+    MonteCarloOptions options;
+    options.seed = 17;
+    options.target_error = 2e-3;
+    const MonteCarloResult estimate = calculator.EstimateHandVsHand(hand1, hand2, board, {},
+                                                                    options);
+    EXPECT_LE(estimate.error, options.target_error);
+    EXPECT_NEAR(exact, estimate.result.GetEquity(), 2 * options.target_error);
+    EXPECT_LT(estimate.result.win + estimate.result.tie + estimate.result.lose, 2e6)
+        << "should stop early";
+
+    // the same seed gives the same answer on any number of threads
+    const MonteCarloResult again = EquityCalculator(1).EstimateHandVsHand(hand1, hand2, board, {},
+                                                                          options);
+    EXPECT_EQ(estimate.result.win, again.result.win);
+    EXPECT_EQ(estimate.result.tie, again.result.tie);
+}
+
+TEST_F(TestEquity, MonteCarloRangeVsRange) {
+    const std::vector<double> range1 = EquityCalculator::ParseRange("AA,KK:0.5,AKs,7c6c");
+    const std::vector<double> range2 = EquityCalculator::ParseRange("QQ,JTs:0.25,AhKd");
+    const std::vector<u32> board = Utils::ParseCards("Ks8c5d");
+    const double exact = calculator.RangeVsRange(range1, range2, board).total.GetEquity();
+
+    MonteCarloOptions options;
+    options.seed = 3;
+    options.target_error = 2e-3;
+    const MonteCarloResult estimate = calculator.EstimateRangeVsRange(range1, range2, board, {},
+                                                                      options);
+    EXPECT_NEAR(exact, estimate.result.GetEquity(), 2 * options.target_error);
+
+    EXPECT_THROW(static_cast<void>(calculator.EstimateRangeVsRange(
+                     EquityCalculator::ParseRange("AhAs"), EquityCalculator::ParseRange("AhKh"))),
+                 std::invalid_argument);
+}
+
+TEST_F(TestEquity, ParseRange) {
+    auto count = [](const std::string& range) {
+        const std::vector<double> weights = EquityCalculator::ParseRange(range);
+        return std::accumulate(weights.begin(), weights.end(), 0.0);
+    };
+
+    EXPECT_EQ(6, count("AA"));
+    EXPECT_EQ(4, count("AKs"));
+    EXPECT_EQ(12, count("KAo"));
+    EXPECT_EQ(16, count("AK"));
+    EXPECT_EQ(6 + 16 + 0.5, count("22, T9, AhKh:0.5"));
+    EXPECT_EQ(6, count("AA,AA")) << "repeated hands shouldn't add up";
+
+    EXPECT_THROW(EquityCalculator::ParseRange("AAs"), std::invalid_argument);
+    EXPECT_THROW(EquityCalculator::ParseRange("AX"), std::invalid_argument);
+    EXPECT_THROW(EquityCalculator::ParseRange("AhAh"), std::invalid_argument);
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "solver/equity/preflop_equity.h"
+#include "solver/utils/utils.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+class TestPreflopEquity : public testing::Test {
+protected:
+    std::string path = testing::TempDir() + "test_preflop_equity.bin";
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    // A made-up table: class1 against class2 is (class1 + 1) / (class1 + class2 + 2).
+    static std::vector<float> MakeClasses() {
+        std::vector<float> classes(Utils::NUM_HAND_CLASSES * Utils::NUM_HAND_CLASSES);
+        for (int i = 0; i < Utils::NUM_HAND_CLASSES; ++i)
+            for (int j = 0; j < Utils::NUM_HAND_CLASSES; ++j)
+                classes[i * Utils::NUM_HAND_CLASSES + j] = (i + 1.0f) / (i + j + 2.0f);
+        return classes;
+    }
+
+    static bool ShareACard(const int combo1, const int combo2) {
+        auto [a, b] = Utils::ComboToIndices(combo1);
+        auto [c, d] = Utils::ComboToIndices(combo2);
+        return a == c || a == d || b == c || b == d;
+    }
+};
+
+TEST_F(TestPreflopEquity, SaveAndLoad) {
+    std::vector<float> combos(Utils::NUM_COMBOS * Utils::NUM_COMBOS, 0.25f);
+    combos[5 * Utils::NUM_COMBOS + 7] = NAN;
+    PreflopEquityTable(MakeClasses(), combos).Save(path);
+
+    const PreflopEquityTable table = PreflopEquityTable::Load(path);
+    ASSERT_TRUE(table.HasComboEquities());
+    const int aa = Utils::ParseHandClass("AA"), kk = Utils::ParseHandClass("KK");
+    EXPECT_FLOAT_EQ((aa + 1.0f) / (aa + kk + 2.0f), table.GetEquity(aa, kk));
+    EXPECT_FLOAT_EQ(0.25, table.GetComboEquity(7, 5));
+    EXPECT_TRUE(std::isnan(table.GetComboEquity(5, 7)));
+
+    // without combos
+    PreflopEquityTable(MakeClasses()).Save(path);
+    const PreflopEquityTable classes_only = PreflopEquityTable::Load(path);
+    EXPECT_FALSE(classes_only.HasComboEquities());
+    EXPECT_FLOAT_EQ(0.5, classes_only.GetEquity(3, 3));
+}
+
+TEST_F(TestPreflopEquity, BadFiles) {
+    EXPECT_THROW(PreflopEquityTable::Load(path), std::runtime_error) << "missing file";
+
+    std::ofstream(path) << "not a table";
+    EXPECT_THROW(PreflopEquityTable::Load(path), std::runtime_error) << "bad magic";
+
+    // bump the version
+    PreflopEquityTable(MakeClasses()).Save(path);
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(8);
+        const u32 version = PreflopEquityTable::VERSION + 1;
+        file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    }
+    EXPECT_THROW(PreflopEquityTable::Load(path), std::runtime_error) << "wrong version";
+
+    EXPECT_THROW(PreflopEquityTable(std::vector<float>(10)), std::invalid_argument);
+}
+
+TEST_F(TestPreflopEquity, CanonicalMatchup) {
+    // relabelling the suits of both hands keeps the key
+    for (const auto& [hand1, hand2]: {std::pair("AhKh", "QsQc"), std::pair("7c2d", "7h2s"),
+                                      std::pair("AsAd", "KsQd")}) {
+        const std::vector<u32> cards1 = Utils::ParseCards(hand1);
+        const std::vector<u32> cards2 = Utils::ParseCards(hand2);
+        const int combo1 = Utils::ComboIndex(Utils::CardToIndex(cards1[0]),
+                                             Utils::CardToIndex(cards1[1]));
+        const int combo2 = Utils::ComboIndex(Utils::CardToIndex(cards2[0]),
+                                             Utils::CardToIndex(cards2[1]));
+        const u32 key = PreflopEquityTable::CanonicalMatchup(combo1, combo2);
+
+        std::array<int, 4> suits = {0, 1, 2, 3};
+        while (std::ranges::next_permutation(suits).found) {
+            auto relabel = [&](const u32 card) {
+                const int index = Utils::CardToIndex(card);
+                return index - index % 4 + suits[index % 4];
+            };
+            EXPECT_EQ(key, PreflopEquityTable::CanonicalMatchup(
+                               Utils::ComboIndex(relabel(cards1[0]), relabel(cards1[1])),
+                               Utils::ComboIndex(relabel(cards2[0]), relabel(cards2[1]))))
+                << hand1 << " vs " << hand2;
+        }
+    }
+
+    // up to suits there are 93769 matchups of one hand against another, and 47008 if swapping
+    // the hands makes no difference
+    std::unordered_set<u32> keys;
+    for (int combo1 = 0; combo1 < Utils::NUM_COMBOS; ++combo1)
+        for (int combo2 = 0; combo2 < Utils::NUM_COMBOS; ++combo2)
+            if (!ShareACard(combo1, combo2))
+                keys.insert(PreflopEquityTable::CanonicalMatchup(combo1, combo2));
+    EXPECT_EQ(93769, keys.size());
+    const auto unordered = std::ranges::count_if(keys, [](const u32 key) {
+        const int combo1 = static_cast<int>(key / Utils::NUM_COMBOS);
+        const int combo2 = static_cast<int>(key % Utils::NUM_COMBOS);
+        return key <= PreflopEquityTable::CanonicalMatchup(combo2, combo1);
+    });
+    EXPECT_EQ(47008, unordered);
+}
+
+TEST_F(TestPreflopEquity, CommittedTable) {
+    // the table in data/, computed by gen_preflop_equity; if this fails, regenerate it
+    const PreflopEquityTable table = PreflopEquityTable::Load(PREFLOP_EQUITY_TABLE);
+    const EquityCalculator calculator;
+    for (const auto& [class1, class2]: {std::pair("AA", "KK"), std::pair("AKo", "QQ"),
+                                        std::pair("72o", "AA")}) {
+        // the classes' combo matchups, counted by key so that each is only run once
+        const int h1 = Utils::ParseHandClass(class1), h2 = Utils::ParseHandClass(class2);
+        std::map<u32, int> matchups;
+        for (int combo1 = 0; combo1 < Utils::NUM_COMBOS; ++combo1)
+            for (int combo2 = 0; combo2 < Utils::NUM_COMBOS; ++combo2)
+                if (Utils::ComboToHandClass(combo1) == h1 && Utils::ComboToHandClass(combo2) == h2
+                    && !ShareACard(combo1, combo2))
+                    ++matchups[PreflopEquityTable::CanonicalMatchup(combo1, combo2)];
+
+        double sum = 0;
+        int count = 0;
+        for (const auto& [key, n]: matchups) {
+            auto [a, b] = Utils::ComboToIndices(static_cast<int>(key / Utils::NUM_COMBOS));
+            auto [c, d] = Utils::ComboToIndices(static_cast<int>(key % Utils::NUM_COMBOS));
+            const std::array hand1 = {Utils::IndexToCard(a), Utils::IndexToCard(b)};
+            const std::array hand2 = {Utils::IndexToCard(c), Utils::IndexToCard(d)};
+            sum += n * calculator.HandVsHand(hand1, hand2).GetEquity();
+            count += n;
+        }
+        EXPECT_NEAR(sum / count, table.GetEquity(h1, h2), 1e-6) << class1 << " vs " << class2;
+    }
+}
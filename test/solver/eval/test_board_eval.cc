@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include "solver/eval/board_eval.h"
+#include "solver/eval/eval.h"
+#include "solver/utils/utils.h"
+#include <vector>
+
+class TestBoardEval : public testing::Test {
+protected:
+    Eval eval;
+
+    // GetBestHand of board plus the combo's two cards
+    int Expected(const std::vector<u32>& board, const int combo) const {
+        auto [i, j] = Utils::ComboToIndices(combo);
+        std::vector<u32> cards = board;
+        cards.push_back(Utils::IndexToCard(i));
+        cards.push_back(Utils::IndexToCard(j));
+        return eval.GetBestHand(cards);
+    }
+};
+
+TEST_F(TestBoardEval, MatchesGetBestHand) {
+    for (const std::string board_string: {"AhKhQh2c7d", "9s9c4d", "Tc8c6c2c"}) {
+        const std::vector<u32> board = Utils::ParseCards(board_string);
+        const BoardEval board_eval(board);
+        const u64 board_mask = Utils::CardsToMask(board);
+
+        for (int combo = 0; combo < Utils::NUM_COMBOS; ++combo) {
+            auto [i, j] = Utils::ComboToIndices(combo);
+            if ((board_mask >> i | board_mask >> j) & 1)
+                ASSERT_EQ(0, board_eval.GetRank(combo))
+                    << "blocked combo ranked on " << board_string;
+            else
+                ASSERT_EQ(Expected(board, combo), board_eval.GetRank(combo))
+                    << "WA on combo " << combo << " on " << board_string;
+        }
+    }
+}
+
+TEST_F(TestBoardEval, SortedCombos) {
+    const BoardEval board_eval(Utils::CardsToMask(Utils::ParseCards("AhKhQh2c7d")));
+    const std::span<const u16> sorted = board_eval.GetSortedCombos();
+
+    EXPECT_EQ(47 * 46 / 2, sorted.size()) << "every unblocked combo should be listed once";
+    const int royal = Utils::ComboIndex(Utils::CardToIndex(Utils::ParseCard("Jh")),
+                                        Utils::CardToIndex(Utils::ParseCard("Th")));
+    EXPECT_EQ(royal, sorted.front()) << "JhTh should be the nuts";
+    for (size_t k = 1; k < sorted.size(); ++k)
+        ASSERT_LE(board_eval.GetRank(sorted[k - 1]), board_eval.GetRank(sorted[k])) << "not sorted";
+
+    EXPECT_THROW(BoardEval(Utils::ParseCards("AhKh")), std::invalid_argument);
+    EXPECT_THROW(BoardEval(Utils::CardsToMask(Utils::ParseCards("AhKhQh")) | 1ULL << 52),
+                 std::invalid_argument);
+}
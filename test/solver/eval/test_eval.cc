@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 #include "solver/eval/eval.h"
 #include "solver/utils/utils.h"
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <random>
 #include <vector>
 
 class TestEval : public testing::Test {
@@ -156,6 +160,13 @@ TEST_F(TestEval, HighCard) {
     EXPECT_EQ(6186, eval.EvaluateHand(cards)) << "WA on AdKhQsJc9h";
 }
 
+TEST_F(TestEval, InvalidHand) {
+    // No hand has five aces, and the lookup must not make one up
+    EXPECT_THROW(static_cast<void>(eval.EvaluateHand(Utils::ParseCards("AcAdAhAsAc"))),
+                 std::invalid_argument);
+    EXPECT_EQ(11, eval.EvaluateHand(Utils::ParseCards("AcAdAhAsKd"))) << "WA on AcAdAhAsKd";
+}
+
 TEST_F(TestEval, GetBestHand) {
     // Royal flush vs straight flush vs 2 pair
     std::vector<u32> cards = Utils::ParseCards("AcKcQcJcTcAhTd");
@@ -176,4 +187,86 @@ TEST_F(TestEval, GetBestHand) {
     cards = Utils::ParseCards("3c3s3dAdKdQdTs");
     expected = eval.EvaluateHand(Utils::ParseCards("3c3s3dAdKd"));
     EXPECT_EQ(expected, eval.GetBestHand(cards)) << "WA on GetBestHand trips";
-}
\ No newline at end of file
+}
+
+TEST_F(TestEval, GetBestHandMatchesSubsets) {
+    // Compare against the best EvaluateHand over every 5-card subset of random 6 and 7 card hands
+    std::vector<u32> deck = Utils::MakeDeck();
+    std::mt19937 rng(47544);
+
+    for (int trial = 0; trial < 20000; ++trial) {
+        std::ranges::shuffle(deck, rng);
+        const int num_cards = 6 + trial % 2;
+        const std::vector cards(deck.begin(), deck.begin() + num_cards);
+
+        int expected = INT_MAX;
+        for (int skip_mask = 0; skip_mask < 1 << num_cards; ++skip_mask) {
+            if (std::popcount(static_cast<unsigned>(skip_mask)) != num_cards - 5) continue;
+            std::vector<u32> hand;
+            for (int i = 0; i < num_cards; ++i)
+                if (!(skip_mask >> i & 1)) hand.push_back(cards[i]);
+            expected = std::min(expected, eval.EvaluateHand(hand));
+        }
+
+        ASSERT_EQ(expected, eval.GetBestHand(cards)) << "WA on trial " << trial;
+    }
+
+    // 5 cards are just EvaluateHand
+    std::vector<u32> cards = Utils::ParseCards("Ad2h3h4h5c");
+    EXPECT_EQ(eval.EvaluateHand(cards), eval.GetBestHand(cards)) << "WA on Ad2h3h4h5c";
+
+    EXPECT_THROW(static_cast<void>(eval.GetBestHand(Utils::ParseCards("AdAh"))),
+                 std::invalid_argument);
+}
+
+TEST_F(TestEval, FixedSizeOverloads) {
+    const std::vector<u32> cards = Utils::ParseCards("3c3s3dAdKdQdTs");
+
+    const std::array<u32, 5> five = {cards[0], cards[1], cards[2], cards[3], cards[4]};
+    EXPECT_EQ(eval.EvaluateHand(std::vector(cards.begin(), cards.begin() + 5)),
+              eval.EvaluateHand(five)) << "WA on EvaluateHand(std::array)";
+    EXPECT_EQ(eval.EvaluateHand(five),
+              eval.EvaluateHand(cards[0], cards[1], cards[2], cards[3], cards[4]))
+        << "WA on EvaluateHand(c1, ..., c5)";
+    EXPECT_EQ(eval.EvaluateHand(five), eval.GetBestHand(five)) << "WA on GetBestHand<5>";
+
+    const std::array<u32, 6> six = {cards[0], cards[1], cards[2], cards[3], cards[4], cards[5]};
+    EXPECT_EQ(eval.GetBestHand(std::vector(cards.begin(), cards.begin() + 6)),
+              eval.GetBestHand(six)) << "WA on GetBestHand<6>";
+
+    std::array<u32, 7> seven{};
+    std::ranges::copy(cards, seven.begin());
+    EXPECT_EQ(eval.GetBestHand(cards), eval.GetBestHand(seven)) << "WA on GetBestHand<7>";
+    EXPECT_EQ(eval.GetBestHand(cards), eval.GetBestHand(std::span(seven)))
+        << "WA on GetBestHand(std::span)";
+
+    EXPECT_THROW(static_cast<void>(eval.EvaluateHand(cards)), std::invalid_argument);
+}
+
+TEST_F(TestEval, GetBestHands) {
+    // The batch (AVX2 where available) must agree with GetBestHand, including the tail that
+    // doesn't fill a whole batch of 8
+    std::vector<u32> deck = Utils::MakeDeck();
+    std::mt19937 rng(1326);
+
+    for (int cards_per_hand = 5; cards_per_hand <= 7; ++cards_per_hand) {
+        constexpr int num_hands = 1003;
+        std::vector<u32> cards;
+        for (int i = 0; i < num_hands; ++i) {
+            std::ranges::shuffle(deck, rng);
+            cards.insert(cards.end(), deck.begin(), deck.begin() + cards_per_hand);
+        }
+
+        std::vector<u16> ranks(num_hands);
+        eval.GetBestHands(cards, cards_per_hand, ranks);
+        for (int i = 0; i < num_hands; ++i) {
+            const auto hand = std::span(cards).subspan(i * cards_per_hand, cards_per_hand);
+            ASSERT_EQ(eval.GetBestHand(hand), ranks[i])
+                << "WA on hand " << i << " of " << cards_per_hand << " cards";
+        }
+    }
+
+    std::vector<u16> ranks(2);
+    EXPECT_THROW(eval.GetBestHands(Utils::ParseCards("AcKcQcJcTc"), 5, ranks),
+                 std::invalid_argument);
+}
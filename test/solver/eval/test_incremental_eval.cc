@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include "solver/eval/eval.h"
+#include "solver/eval/incremental_eval.h"
+#include "solver/utils/utils.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST(TestIncrementalEval, MatchesGetBestHand) {
+    constexpr Eval eval;
+    const IncrementalEval incremental_eval;
+    std::vector<u32> deck = Utils::MakeDeck();
+    std::mt19937 rng(2718);
+
+    for (int t = 0; t < 100000; ++t) {
+        std::ranges::shuffle(deck, rng);
+        IncrementalEval::State state;
+        for (int n = 1; n <= 7; ++n) {
+            state = incremental_eval.Add(state, deck[n - 1]);
+            if (n >= 5) {
+                ASSERT_EQ(eval.GetBestHand(std::span(deck).first(n)),
+                          incremental_eval.GetRank(state)) << "WA on " << n << " cards";
+            }
+        }
+    }
+}
+
+TEST(TestIncrementalEval, SharedPrefix) {
+    constexpr Eval eval;
+    const IncrementalEval incremental_eval;
+    const std::vector<u32> hand = Utils::ParseCards("AhKhQhJh2c");
+
+    IncrementalEval::State prefix;
+    for (const u32 card: hand)
+        prefix = incremental_eval.Add(prefix, card);
+
+    // extending one state for every river leaves the prefix usable
+    for (const std::string river: {"Th", "Ac", "2d", "9h"}) {
+        std::vector<u32> cards = hand;
+        cards.push_back(Utils::ParseCard(river));
+        EXPECT_EQ(eval.GetBestHand(cards),
+                  incremental_eval.GetRank(incremental_eval.Add(prefix, cards.back())))
+            << "WA with river " << river;
+    }
+    EXPECT_EQ(eval.GetBestHand(hand), incremental_eval.GetRank(prefix));
+}
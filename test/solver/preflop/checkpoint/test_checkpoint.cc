@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "solver/preflop/checkpoint/checkpoint.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class TestCheckpoint : public testing::Test {
+protected:
+    std::string path = testing::TempDir() + "test_checkpoint.bin";
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    // A root with a fold and a call, and 3 hands stored as floats.
+    static Checkpoint::Data MakeData() {
+        Checkpoint::Data data{
+            {100, 100, 0.9, 0, 1, 4, 0}, 42, InfosetStore::Precision::FLOAT, 3,
+            {{0.5, 1, 1, 0, 0, 2}, {0.5, 1, 1, 1, 0, 0}, {1, 1, 0, 2, 0, 0}},
+            {Checkpoint::ActionKind::FOLD, Checkpoint::ActionKind::CALL}, {}, {}
+        };
+        const std::vector<float> regrets = {1.5f, -2, 0.25f, 4, 0, -1};
+        const std::vector<float> strategy_sums = {3, 2, 1, 0, 1, 2};
+        data.regrets.resize(regrets.size() * sizeof(float));
+        std::memcpy(data.regrets.data(), regrets.data(), data.regrets.size());
+        data.strategy_sums.resize(strategy_sums.size() * sizeof(float));
+        std::memcpy(data.strategy_sums.data(), strategy_sums.data(), data.strategy_sums.size());
+        return data;
+    }
+};
+
+TEST_F(TestCheckpoint, SaveAndLoad) {
+    const Checkpoint::Data data = MakeData();
+    Checkpoint::Save(path, data);
+
+    const Checkpoint checkpoint = Checkpoint::Load(path);
+    EXPECT_EQ(data.config, checkpoint.GetConfig());
+    EXPECT_EQ(42, checkpoint.GetNumIterations());
+    EXPECT_EQ(InfosetStore::Precision::FLOAT, checkpoint.GetPrecision());
+    EXPECT_EQ(3, checkpoint.GetNumHands());
+    EXPECT_TRUE(std::ranges::equal(data.nodes, checkpoint.GetNodes()));
+    EXPECT_TRUE(std::ranges::equal(data.actions, checkpoint.GetActions()));
+    EXPECT_TRUE(std::ranges::equal(data.regrets, checkpoint.GetRegretData()));
+    EXPECT_TRUE(std::ranges::equal(data.strategy_sums, checkpoint.GetStrategySumData()));
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(checkpoint.GetRegretData().data())
+                 % InfosetStore::ALIGNMENT) << "Values are aligned as in the store";
+}
+
+TEST_F(TestCheckpoint, BadFiles) {
+    EXPECT_THROW(Checkpoint::Load(path), std::runtime_error) << "missing file";
+
+    std::ofstream(path) << "not a checkpoint";
+    EXPECT_THROW(Checkpoint::Load(path), std::runtime_error) << "bad magic";
+
+    // bump the version
+    Checkpoint::Save(path, MakeData());
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(8);
+        const uint32_t version = Checkpoint::VERSION + 1;
+        file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+    }
+    EXPECT_THROW(Checkpoint::Load(path), std::runtime_error) << "wrong version";
+
+    // cut off the last value, as a crash mid-write would
+    Checkpoint::Save(path, MakeData());
+    std::vector<char> contents;
+    {
+        std::ifstream file(path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator(file), {});
+    }
+    std::ofstream(path, std::ios::binary).write(contents.data(),
+                                               static_cast<std::streamsize>(contents.size() - 4));
+    EXPECT_THROW(Checkpoint::Load(path), std::runtime_error) << "truncated";
+}
+
+TEST_F(TestCheckpoint, Writer) {
+    {
+        CheckpointWriter writer(path);
+        Checkpoint::Data data = MakeData();
+        for (int i = 0; i < 5; ++i) {
+            data.num_iterations = i;
+            writer.Submit(data);
+        }
+        writer.Flush();
+        EXPECT_EQ(4, Checkpoint::Load(path).GetNumIterations()) << "The newest one is written";
+
+        data.num_iterations = 10;
+        writer.Submit(data);
+    }
+    EXPECT_EQ(10, Checkpoint::Load(path).GetNumIterations()) << "Pending checkpoints are written "
+                                                                "on destruction";
+
+    CheckpointWriter writer(testing::TempDir() + "missing/test_checkpoint.bin");
+    writer.Submit(MakeData());
+    EXPECT_THROW(writer.Flush(), std::runtime_error);
+}
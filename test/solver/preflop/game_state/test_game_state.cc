@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include "solver/preflop/game_state/game_state.h"
+#include <memory>
+#include <vector>
+
+TEST(TestGameState, Blinds) {
+    const GameState state(1, 0, 1, 100, 100, {}, 4);
+    EXPECT_EQ(std::make_pair(0.5, 1.0), state.GetTotalBets());
+    EXPECT_DOUBLE_EQ(99.5, state.GetChipsRemaining(1));
+    EXPECT_DOUBLE_EQ(99, state.GetChipsRemaining(2));
+    EXPECT_DOUBLE_EQ(1, state.GetLastRaise());
+    EXPECT_FALSE(state.IsTerminal());
+    EXPECT_TRUE(state.CanRaise());
+
+    const GameState reversed(2, 1, 0, 100, 100, {}, 4);
+    EXPECT_EQ(std::make_pair(1.0, 0.5), reversed.GetTotalBets());
+}
+
+TEST(TestGameState, ReplayHistory) {
+    // SB raises to 2.5, BB 3-bets to 10, SB calls
+    const GameState state(2, 0, 1, 100, 100,
+                          {PreflopAction::Raise(2.5), PreflopAction::Raise(4),
+                           PreflopAction::Call()}, 4);
+    EXPECT_EQ(std::make_pair(10.0, 10.0), state.GetTotalBets());
+    EXPECT_DOUBLE_EQ(7.5, state.GetLastRaise());
+    EXPECT_TRUE(state.IsTerminal());
+
+    const GameState previous = state.GetPreviousGameState();
+    EXPECT_EQ(1, previous.player_to_move);
+    EXPECT_EQ(std::make_pair(2.5, 10.0), previous.GetTotalBets());
+    EXPECT_FALSE(previous.IsTerminal());
+}
+
+TEST(TestGameState, GetNextGameState) {
+    const GameState root(1, 0, 1, 100, 100, {}, 4);
+    const GameState limped = root.GetNextGameState(PreflopAction::Call());
+    EXPECT_EQ(2, limped.player_to_move);
+    EXPECT_EQ(std::make_pair(1.0, 1.0), limped.GetTotalBets());
+    EXPECT_FALSE(limped.IsTerminal()) << "The big blind still has an option";
+
+    const GameState checked = limped.GetNextGameState(PreflopAction::Check());
+    EXPECT_TRUE(checked.IsTerminal());
+
+    const GameState jammed = root.GetNextGameState(PreflopAction::AllIn());
+    EXPECT_EQ(std::make_pair(100.0, 1.0), jammed.GetTotalBets());
+    EXPECT_FALSE(jammed.CanRaise()) << "Nobody can raise an all-in";
+}
+
+TEST(TestGameState, EffectiveStack) {
+    // the small blind covers; an all-in only puts the effective stack at risk
+    const GameState state(2, 0, 1, 100, 20, {PreflopAction::AllIn()}, 4);
+    EXPECT_EQ(std::make_pair(20.0, 1.0), state.GetTotalBets());
+    EXPECT_DOUBLE_EQ(20, state.GetEffectiveStack());
+
+    const GameState called = state.GetNextGameState(PreflopAction::Call());
+    EXPECT_EQ(std::make_pair(20.0, 20.0), called.GetTotalBets());
+    EXPECT_DOUBLE_EQ(0, called.GetChipsRemaining(2));
+}
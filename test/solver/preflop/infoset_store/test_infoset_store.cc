@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "solver/preflop/infoset_store/infoset_store.h"
+#include "solver/preflop/node/node.h"
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(TestInfosetStore, Layout) {
+    const std::vector num_actions = {2, 3};
+    const InfosetStore store(num_actions, 169);
+    EXPECT_EQ(2, store.GetNumDecisions());
+    EXPECT_EQ(169, store.GetNumHands());
+    EXPECT_EQ(3, store.GetNumActions(1));
+    EXPECT_EQ(InfosetStore::Precision::DOUBLE, store.GetPrecision());
+
+    // rows of 169 hands are padded to 176 doubles (22 cache lines)
+    EXPECT_GE(store.GetFootprint(), 2 * 5 * 176 * sizeof(double));
+    EXPECT_LT(store.GetFootprint(), 2 * 5 * 176 * sizeof(double) + 1024);
+
+    const InfosetStore floats(num_actions, 169, InfosetStore::Precision::FLOAT);
+    EXPECT_LT(floats.GetFootprint(), store.GetFootprint() * 3 / 5)
+        << "Floats should take about half the memory";
+
+    // 6 and 3 bytes per pair of values, rows padded to 192 hands, plus a scale per row
+    const InfosetStore fixed32(num_actions, 169, InfosetStore::Precision::FIXED32);
+    EXPECT_LT(fixed32.GetFootprint(), store.GetFootprint() / 2);
+    const InfosetStore fixed16(num_actions, 169, InfosetStore::Precision::FIXED16);
+    EXPECT_LT(fixed16.GetFootprint(), store.GetFootprint() / 4);
+}
+
+TEST(TestInfosetStore, RegretMatching) {
+    // the regrets are exact at every precision
+    for (const auto precision: {InfosetStore::Precision::DOUBLE, InfosetStore::Precision::FLOAT,
+                                InfosetStore::Precision::FIXED32,
+                                InfosetStore::Precision::FIXED16}) {
+        const std::vector num_actions = {1, 3};
+        InfosetStore store(num_actions, 2, precision);
+
+        // hand 0 has regrets {3, -1, 1}; hand 1 has none positive
+        const std::vector<double> regrets = {3, 0, -1, -2, 1, 0};
+        store.AddRegrets(1, regrets);
+        EXPECT_EQ(-1, store.GetRegret(1, 0, 1));
+
+        std::vector<double> strategy(6);
+        store.GetStrategy(1, strategy);
+        EXPECT_DOUBLE_EQ(0.75, strategy[0]);
+        EXPECT_DOUBLE_EQ(0, strategy[2]);
+        EXPECT_DOUBLE_EQ(0.25, strategy[4]);
+        for (const int a: {1, 3, 5})
+            EXPECT_DOUBLE_EQ(1.0 / 3, strategy[a]) << "No positive regret should play uniformly";
+
+        std::vector<double> single(3);
+        store.GetStrategy(1, 0, single);
+        EXPECT_EQ(std::vector<double>({0.75, 0, 0.25}), single);
+
+        // the only action of decision 0 is always played
+        std::vector<double> only(2);
+        store.GetStrategy(0, only);
+        EXPECT_EQ(std::vector<double>({1, 1}), only);
+
+        const std::vector<double> reach = {2, 0.5};
+        store.AddStrategy(1, reach, strategy);
+        store.AddStrategy(1, reach, strategy);
+        EXPECT_DOUBLE_EQ(3, store.GetStrategySum(1, 0, 0));
+
+        std::vector<double> average(6);
+        store.GetAverageStrategy(1, average);
+        // half floats and 8-bit sums hold thirds only to a step
+        const double tolerance = precision == InfosetStore::Precision::FIXED16   ? 1e-2
+                                 : precision == InfosetStore::Precision::FIXED32 ? 1e-3
+                                                                                 : 1e-6;
+        for (size_t i = 0; i < average.size(); ++i)
+            EXPECT_NEAR(strategy[i], average[i], tolerance);
+    }
+}
+
+TEST(TestInfosetStore, NodeView) {
+    const std::vector num_actions = {2};
+    InfosetStore store(num_actions, 3);
+    Node node(store, 0, 1);
+
+    node.UpdateRegret(0, 1);
+    node.UpdateRegret(1, 3);
+    EXPECT_EQ(3, store.GetRegret(0, 1, 1)) << "Node should write through to the store";
+    EXPECT_EQ(0, store.GetRegret(0, 0, 1)) << "Other hands are untouched";
+
+    const std::vector<double> strategy = node.GetStrategy(2);
+    EXPECT_DOUBLE_EQ(0.25, strategy[0]);
+    EXPECT_DOUBLE_EQ(1.5, store.GetStrategySum(0, 1, 1));
+
+    std::vector<double> vectorized(6);
+    store.GetStrategy(0, vectorized);
+    EXPECT_DOUBLE_EQ(strategy[0], vectorized[1]);
+    EXPECT_DOUBLE_EQ(strategy[1], vectorized[4]);
+
+    const std::vector<double> average = node.GetAverageStrategy();
+    EXPECT_DOUBLE_EQ(0.25, average[0]);
+    EXPECT_DOUBLE_EQ(0.75, average[1]);
+}
+
+TEST(TestInfosetStore, Concurrent) {
+    const std::vector num_actions = {2};
+    InfosetStore store(num_actions, 3, InfosetStore::Precision::FLOAT);
+    store.SetConcurrent(true);
+
+    // integer amounts add up exactly in floats, so every lost update would show
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&] {
+            const std::vector<double> regrets = {1, 1, 1, 2, 2, 2};
+            for (int i = 0; i < 10000; ++i)
+                store.AddRegrets(0, regrets);
+        });
+    for (std::thread &thread: threads)
+        thread.join();
+
+    EXPECT_EQ(40000, store.GetRegret(0, 2, 0));
+    EXPECT_EQ(80000, store.GetRegret(0, 1, 1));
+}
+
+TEST(TestInfosetStore, Discount) {
+    const std::vector num_actions = {2};
+    InfosetStore store(num_actions, 1);
+    store.AddRegret(0, 0, 0, 4);
+    store.AddRegret(0, 0, 1, -4);
+    store.AddStrategySum(0, 0, 1, 2);
+
+    store.Discount(0.5, 0, 0.25);
+    EXPECT_EQ(2, store.GetRegret(0, 0, 0));
+    EXPECT_EQ(0, store.GetRegret(0, 0, 1));
+    EXPECT_EQ(0.5, store.GetStrategySum(0, 0, 1));
+}
+
+TEST(TestInfosetStore, FixedPoint) {
+    const std::vector num_actions = {2};
+    for (const auto precision: {InfosetStore::Precision::FIXED32,
+                                InfosetStore::Precision::FIXED16}) {
+        InfosetStore store(num_actions, 3, precision);
+        EXPECT_THROW(store.SetConcurrent(true), std::invalid_argument);
+
+        // a large value widens its row's steps, but small updates still add up on average
+        store.AddRegret(0, 0, 0, 1e6);
+        for (int i = 0; i < 10000; ++i)
+            store.AddRegret(0, 1, 0, 1);
+        EXPECT_NEAR(1e6, store.GetRegret(0, 0, 0), 1e6 * 1e-4);
+        EXPECT_NEAR(10000, store.GetRegret(0, 1, 0), 500);
+        EXPECT_EQ(0, store.GetRegret(0, 1, 1)) << "Other rows keep their own scale";
+        store.AddRegret(0, 1, 1, -0.001);
+        EXPECT_NEAR(-0.001, store.GetRegret(0, 1, 1), 1e-6);
+
+        // the sums of many small strategy updates keep their proportions
+        const std::vector<double> reach = {1, 1, 1}, strategy = {0.1, 0.5, 0.7, 0.9, 0.5, 0.3};
+        for (int i = 0; i < 2000; ++i)
+            store.AddStrategy(0, reach, strategy);
+        std::vector<double> average(6);
+        store.GetAverageStrategy(0, average);
+        for (size_t i = 0; i < average.size(); ++i)
+            EXPECT_NEAR(strategy[i], average[i], 0.02) << i;
+
+        // an uneven discount refits the rows
+        store.Discount(0.5, 0, 0.5);
+        EXPECT_NEAR(5e5, store.GetRegret(0, 0, 0), 5e5 * 1e-4);
+        EXPECT_EQ(0, store.GetRegret(0, 1, 1));
+        EXPECT_NEAR(0.5 * 2000 * 0.1, store.GetStrategySum(0, 0, 0), 10);
+    }
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "solver/preflop/node/node.h"
+#include <memory>
+#include <vector>
+
+class TestNode : public testing::Test {
+protected:
+    void SetUp() override {
+        action_space = {PreflopAction::Fold(), PreflopAction::Check(), PreflopAction::Call(),
+                        PreflopAction::Raise(2), PreflopAction::AllIn()};
+    }
+
+    // small blind (player 1) to act first, 100bb deep
+    static std::shared_ptr<GameState> MakeState(
+        const int player_to_move, std::vector<std::shared_ptr<PreflopAction> > history) {
+        return std::make_shared<GameState>(player_to_move, 0, 1, 100, 100, std::move(history), 4);
+    }
+
+    std::vector<std::shared_ptr<PreflopAction> > action_space;
+};
+
+TEST_F(TestNode, GetLegalActions) {
+    const Node root(MakeState(1, {}), 1, action_space);
+    const std::vector<std::shared_ptr<PreflopAction> > expected = {
+        action_space[0], action_space[2], action_space[3], action_space[4]
+    };
+    EXPECT_EQ(expected, root.GetLegalActions()) << "Small blind can fold, limp, raise or jam";
+
+    const Node limped(MakeState(2, {action_space[2]}), 1, action_space);
+    const std::vector<std::shared_ptr<PreflopAction> > expected_limped = {
+        action_space[1], action_space[3], action_space[4]
+    };
+    EXPECT_EQ(expected_limped, limped.GetLegalActions()) << "Big blind can check, raise or jam";
+
+    const Node terminal(MakeState(2, {action_space[0]}), 1, action_space);
+    EXPECT_TRUE(terminal.GetLegalActions().empty());
+}
+
+TEST_F(TestNode, GetStrategy) {
+    Node node(MakeState(1, {}), 1, action_space);
+    for (const double p: node.GetStrategy(1))
+        EXPECT_DOUBLE_EQ(0.25, p) << "Strategy should start uniform";
+
+    node.UpdateRegret(1, 3);
+    node.UpdateRegret(2, 1);
+    node.UpdateRegret(3, -5);
+    const std::vector<double> strategy = node.GetStrategy(1);
+    EXPECT_DOUBLE_EQ(0, strategy[0]);
+    EXPECT_DOUBLE_EQ(0.75, strategy[1]);
+    EXPECT_DOUBLE_EQ(0.25, strategy[2]);
+    EXPECT_DOUBLE_EQ(0, strategy[3]) << "Negative regret should never be played";
+}
+
+TEST_F(TestNode, GetAverageStrategy) {
+    Node node(MakeState(1, {}), 1, action_space);
+    for (const double p: node.GetAverageStrategy())
+        EXPECT_DOUBLE_EQ(0.25, p) << "Average strategy should start uniform";
+
+    // uniform with weight 1, then all-in on action 0 with weight 3
+    node.GetStrategy(1);
+    node.UpdateRegret(0, 2);
+    node.GetStrategy(3);
+    const std::vector<double> average = node.GetAverageStrategy();
+    EXPECT_DOUBLE_EQ((0.25 + 3) / 4, average[0]);
+    EXPECT_DOUBLE_EQ(0.25 / 4, average[1]);
+}
+
+TEST_F(TestNode, GetUtility) {
+    // limped and checked: 1bb each in the pot
+    const Node checked(MakeState(1, {action_space[2], action_space[1]}), 1, action_space);
+    EXPECT_DOUBLE_EQ(0.2, checked.GetUtility(0.6));
+    EXPECT_DOUBLE_EQ(0, checked.GetUtility(0.5)) << "An even matchup is worth nothing";
+
+    const Node realized(MakeState(1, {action_space[2], action_space[1]}), 0.5, action_space);
+    EXPECT_DOUBLE_EQ(0.6 * 0.5 - 0.4, realized.GetUtility(0.6))
+        << "Player 1 realizes only part of what they win";
+}
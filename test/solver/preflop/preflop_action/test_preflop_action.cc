@@ -37,160 +37,179 @@ TEST_F(TestPreflopAction, IsLegalFold) {
     EXPECT_TRUE(fold->IsLegal({2, 0, 1, BB_100, BB_100, {x5_raise}, 4}))
         << "Should be able to fold with outstanding bet";
 
-    // EXPECT_TRUE(fold->IsLegal({1, 0, 1, BB_100,
-    //     BB_100, {x5_raise, x5_raise}, 4}))
-    //     << "Should be able to fold with outstanding bet";
-    //
-    // EXPECT_TRUE(fold->IsLegal({1, 0, 1, BB_100,
-    //     BB_100, mt_history, 4}))
-    //     << "Should be able to fold at the start";
-    //
-    // EXPECT_FALSE(fold->IsLegal({2, 0, 1, BB_100,
-    //     BB_100, mt_history, 4}))
-    //     << "Should not be able to fold out of turn";
-    //
-    // EXPECT_FALSE(fold->IsLegal({2, 0, 1, BB_100,
-    //     BB_100, {call}, 4}))
-    //     << "Should not be able to fold with no outstanding bet";
+    EXPECT_TRUE(fold->IsLegal({1, 0, 1, BB_100, BB_100, {x5_raise, x5_raise}, 4}))
+        << "Should be able to fold with outstanding bet";
+
+    EXPECT_TRUE(fold->IsLegal({1, 0, 1, BB_100, BB_100, mt_history, 4}))
+        << "Should be able to fold at the start";
+
+    EXPECT_FALSE(fold->IsLegal({2, 0, 1, BB_100, BB_100, mt_history, 4}))
+        << "Should not be able to fold out of turn";
+
+    EXPECT_FALSE(fold->IsLegal({2, 0, 1, BB_100, BB_100, {call}, 4}))
+        << "Should not be able to fold with no outstanding bet";
 }
 
 TEST_F(TestPreflopAction, IsLegalCheck) {
-    // EXPECT_TRUE(check->IsLegal({2, 0, 1, BB_100,
-    //     BB_100, {call}, 4}))
-    //     << "Should be able to check with no outstanding bet";
-    //
-    // EXPECT_FALSE(check->IsLegal({2, 0, 1, BB_100,
-    //     BB_100, mt_history, 4}))
-    //     << "Should not be able to check out of turn";
-    //
-    // EXPECT_FALSE(check->IsLegal({2, 0, 1, BB_100,
-    //     BB_100, {min_raise, min_raise}, 4}))
-    //     << "Should not be able to check out of turn";
-    //
-    // EXPECT_FALSE(check->IsLegal({1, 0, 1, BB_100,
-    //     BB_100, mt_history, 4}))
-    //     << "Should not be able to check with outstanding bet";
-    //
-    // EXPECT_FALSE(check->IsLegal({2, 0, 1, BB_100,
-    //     BB_100, {min_raise}, 4}))
-    //     << "Should not be able to check with outstanding bet";
-    //
-    // EXPECT_FALSE(check->IsLegal({2, 0, 1, BB_100,
-    //     BB_100, {all_in}, 4}))
-    //     << "Should not be able to check with outstanding bet";
-    //
-    // EXPECT_FALSE(check->IsLegal({1, 0, 1, BB_100,
-    //     BB_100, {min_raise, call}, 4}))
-    //     << "Should not be able to check after action is over";
+    EXPECT_TRUE(check->IsLegal({2, 0, 1, BB_100, BB_100, {call}, 4}))
+        << "Should be able to check with no outstanding bet";
+
+    EXPECT_FALSE(check->IsLegal({2, 0, 1, BB_100, BB_100, mt_history, 4}))
+        << "Should not be able to check out of turn";
+
+    EXPECT_FALSE(check->IsLegal({2, 0, 1, BB_100, BB_100, {min_raise, min_raise}, 4}))
+        << "Should not be able to check out of turn";
+
+    EXPECT_FALSE(check->IsLegal({1, 0, 1, BB_100, BB_100, mt_history, 4}))
+        << "Should not be able to check with outstanding bet";
+
+    EXPECT_FALSE(check->IsLegal({2, 0, 1, BB_100, BB_100, {min_raise}, 4}))
+        << "Should not be able to check with outstanding bet";
+
+    EXPECT_FALSE(check->IsLegal({2, 0, 1, BB_100, BB_100, {all_in}, 4}))
+        << "Should not be able to check with outstanding bet";
+
+    EXPECT_FALSE(check->IsLegal({1, 0, 1, BB_100, BB_100, {min_raise, call}, 4}))
+        << "Should not be able to check after action is over";
 }
 
 TEST_F(TestPreflopAction, IsLegalCall) {
-    // EXPECT_TRUE(call->IsLegal(BB_100, BB_100, mt_history, 4))
-    //     << "Should be able to call big blind";
-    //
-    // EXPECT_TRUE(call->IsLegal(BB_100, BB_100, {min_raise}, 4))
-    //     << "Should be able to call raise";
-    //
-    // EXPECT_TRUE(call->IsLegal(BB_100, BB_100, {x5_raise}, 4))
-    //     << "Should be able to call raise";
-    //
-    // EXPECT_TRUE(call->IsLegal(BB_100, BB_100, {x5_raise, x5_raise}, 4))
-    //     << "Should be able to call raise";
-    //
-    // EXPECT_TRUE(call->IsLegal(BB_100, BB_100, {all_in}, 4))
-    //     << "Should be able to call all-in";
-    //
-    // EXPECT_TRUE(call->IsLegal(BB_100, 5, {all_in}, 4))
-    //     << "Should be able to call all-in when opponent covers";
-    //
-    // EXPECT_FALSE(call->IsLegal(BB_100, BB_100, {call}, 4))
-    //     << "Should not be able to call without outstanding bet";
-    //
-    // EXPECT_FALSE(call->IsLegal(BB_100, BB_100, mt_history, 4))
-    //     << "Should not be able to call out of turn";
-    //
-    // EXPECT_FALSE(call->IsLegal(BB_100, BB_100, {call, check}, 4))
-    //     << "Should not be able to call after action has finished";
+    EXPECT_TRUE(call->IsLegal({1, 0, 1, BB_100, BB_100, mt_history, 4}))
+        << "Should be able to call big blind";
+
+    EXPECT_TRUE(call->IsLegal({2, 0, 1, BB_100, BB_100, {min_raise}, 4}))
+        << "Should be able to call raise";
+
+    EXPECT_TRUE(call->IsLegal({2, 0, 1, BB_100, BB_100, {x5_raise}, 4}))
+        << "Should be able to call raise";
+
+    EXPECT_TRUE(call->IsLegal({1, 0, 1, BB_100, BB_100, {x5_raise, x5_raise}, 4}))
+        << "Should be able to call raise";
+
+    EXPECT_TRUE(call->IsLegal({2, 0, 1, BB_100, BB_100, {all_in}, 4}))
+        << "Should be able to call all-in";
+
+    EXPECT_TRUE(call->IsLegal({2, 0, 1, BB_100, 5, {all_in}, 4}))
+        << "Should be able to call all-in when opponent covers";
+
+    EXPECT_FALSE(call->IsLegal({2, 0, 1, BB_100, BB_100, {call}, 4}))
+        << "Should not be able to call without outstanding bet";
+
+    EXPECT_FALSE(call->IsLegal({2, 0, 1, BB_100, BB_100, mt_history, 4}))
+        << "Should not be able to call out of turn";
+
+    EXPECT_FALSE(call->IsLegal({1, 0, 1, BB_100, BB_100, {call, check}, 4}))
+        << "Should not be able to call after action has finished";
 }
 
 TEST_F(TestPreflopAction, IsLegalRaise) {
-    // EXPECT_TRUE(min_raise->IsLegal(BB_100, BB_100, mt_history, 4))
-    //     << "Should be able to min-raise";
-    //
-    // EXPECT_TRUE(min_raise->IsLegal(BB_100, BB_100, {min_raise}, 4))
-    //     << "Should be able to min-raise after min-raise";
-    //
-    // EXPECT_TRUE(min_raise->IsLegal(BB_100, BB_100, {call}, 4))
-    //     << "Should be able to min-raise after call";
-    //
-    // EXPECT_TRUE(x5_raise->IsLegal(BB_100, BB_100, {min_raise}, 4))
-    //     << "Should be able to 3-bet after min-raise";
-    //
-    // EXPECT_TRUE(x5_raise->IsLegal(BB_100, BB_100, {min_raise, x5_raise}, 4))
-    //     << "Should be able to 4-bet after 3-bet";
-    //
-    // EXPECT_FALSE(x5_raise->IsLegal(BB_100, 4, {min_raise, min_raise, x5_raise}, 4))
-    //     << "Should not be able to 5-bet";
-    //
-    // EXPECT_FALSE(min_raise->IsLegal(BB_100, BB_100, {min_raise}, 4))
-    //     << "Should not be able to raise out of turn";
-    //
-    // EXPECT_FALSE(min_raise->IsLegal(BB_100, 3, {min_raise}, 4))
-    //     << "Should not be able to raise all-in";
-    //
-    // EXPECT_FALSE(x5_raise->IsLegal(BB_100, 4, {min_raise, min_raise}, 4))
-    //     << "Should not be able to raise opponent all-in";
+    EXPECT_TRUE(min_raise->IsLegal({1, 0, 1, BB_100, BB_100, mt_history, 4}))
+        << "Should be able to min-raise";
+
+    EXPECT_TRUE(min_raise->IsLegal({2, 0, 1, BB_100, BB_100, {min_raise}, 4}))
+        << "Should be able to min-raise after min-raise";
+
+    EXPECT_TRUE(min_raise->IsLegal({2, 0, 1, BB_100, BB_100, {call}, 4}))
+        << "Should be able to min-raise after call";
+
+    EXPECT_TRUE(x5_raise->IsLegal({2, 0, 1, BB_100, BB_100, {min_raise}, 4}))
+        << "Should be able to 3-bet after min-raise";
+
+    EXPECT_TRUE(x5_raise->IsLegal({1, 0, 1, BB_100, BB_100, {min_raise, x5_raise}, 4}))
+        << "Should be able to 4-bet after 3-bet";
+
+    EXPECT_FALSE(x5_raise->IsLegal({1, 0, 1, BB_100, BB_100,
+        {min_raise, min_raise, min_raise, min_raise}, 4}))
+        << "Should not be able to 5-bet";
+
+    EXPECT_FALSE(min_raise->IsLegal({2, 0, 1, BB_100, 3, {min_raise}, 4}))
+        << "Should not be able to raise all-in";
+
+    EXPECT_FALSE(x5_raise->IsLegal({1, 0, 1, BB_100, 4, {min_raise, min_raise}, 4}))
+        << "Should not be able to raise opponent all-in";
+
+    EXPECT_FALSE(PreflopAction::Raise(1.5)->IsLegal({2, 0, 1, BB_100, BB_100, {x5_raise}, 4}))
+        << "Should not be able to raise by less than the last raise";
 }
 
 TEST_F(TestPreflopAction, IsLegalAllIn) {
-    // EXPECT_TRUE(all_in->IsLegal(BB_100, BB_100, mt_history, 4))
-    //     << "Should be able to open jam";
-    //
-    // EXPECT_TRUE(all_in->IsLegal(BB_100, BB_100, {min_raise}, 4))
-    //     << "Should be able to 3-bet jam";
-    //
-    // EXPECT_TRUE(all_in->IsLegal(BB_100, BB_100, {min_raise, min_raise}, 4))
-    //     << "Should be able to 4-bet jam";
-    //
-    // EXPECT_FALSE(
-    //     all_in->IsLegal(BB_100, BB_100, {min_raise, min_raise, min_raise, min_raise},
-    //         4))
-    //     << "Should not be able to 5-bet jam";
-    //
-    // EXPECT_FALSE(all_in->IsLegal(BB_100, BB_100, {min_raise}, 4))
-    //     << "Should not be able to jam out of turn";
+    EXPECT_TRUE(all_in->IsLegal({1, 0, 1, BB_100, BB_100, mt_history, 4}))
+        << "Should be able to open jam";
+
+    EXPECT_TRUE(all_in->IsLegal({2, 0, 1, BB_100, BB_100, {min_raise}, 4}))
+        << "Should be able to 3-bet jam";
+
+    EXPECT_TRUE(all_in->IsLegal({1, 0, 1, BB_100, BB_100, {min_raise, min_raise}, 4}))
+        << "Should be able to 4-bet jam";
+
+    EXPECT_FALSE(
+        all_in->IsLegal({1, 0, 1, BB_100, BB_100, {min_raise, min_raise, min_raise, min_raise},
+            4}))
+        << "Should not be able to 5-bet jam";
+
+    EXPECT_FALSE(all_in->IsLegal({1, 0, 1, BB_100, BB_100, {all_in}, 4}))
+        << "Should not be able to jam over a jam";
 }
 
 TEST_F(TestPreflopAction, GetBetAmountFold) {
-    // ASSERT_EQ(0, fold->GetBetAmount(BB_100, BB_100, mt_history));
-    //
-    // ASSERT_EQ(0, fold->GetBetAmount(BB_100, BB_100, {min_raise}));
+    ASSERT_EQ(0, fold->GetBetAmount({1, 0, 1, BB_100, BB_100, mt_history, 4}));
+
+    ASSERT_EQ(0, fold->GetBetAmount({2, 0, 1, BB_100, BB_100, {min_raise}, 4}));
 }
 
 TEST_F(TestPreflopAction, GetBetAmountCheck) {
-    // ASSERT_EQ(0, check->GetBetAmount(BB_100, BB_100, {call}));
+    ASSERT_EQ(0, check->GetBetAmount({2, 0, 1, BB_100, BB_100, {call}, 4}));
 }
 
 TEST_F(TestPreflopAction, GetBetAmountCall) {
-    // ASSERT_EQ(0.5, call->GetBetAmount(BB_100, BB_100, mt_history));
-    //
-    // ASSERT_EQ(1, call->GetBetAmount(BB_100, BB_100, {min_raise}));
-    //
-    // ASSERT_EQ(2.5, call->GetBetAmount(BB_100, BB_100, {x5_raise}));
-    //
-    // ASSERT_EQ(99, call->GetBetAmount(BB_100, BB_100, {all_in}));
+    ASSERT_EQ(0.5, call->GetBetAmount({1, 0, 1, BB_100, BB_100, mt_history, 4}));
+
+    ASSERT_EQ(1, call->GetBetAmount({2, 0, 1, BB_100, BB_100, {min_raise}, 4}));
+
+    ASSERT_EQ(4, call->GetBetAmount({2, 0, 1, BB_100, BB_100, {x5_raise}, 4}));
+
+    ASSERT_EQ(99, call->GetBetAmount({2, 0, 1, BB_100, BB_100, {all_in}, 4}));
+
+    ASSERT_EQ(19, call->GetBetAmount({2, 0, 1, BB_100, 20, {all_in}, 4}));
 }
 
 TEST_F(TestPreflopAction, GetBetAmountRaise) {
+    ASSERT_EQ(1.5, min_raise->GetBetAmount({1, 0, 1, BB_100, BB_100, mt_history, 4}));
+
+    ASSERT_EQ(9, x5_raise->GetBetAmount({2, 0, 1, BB_100, BB_100, {min_raise}, 4}));
+
+    ASSERT_EQ(1, min_raise->GetBetAmount({2, 0, 1, BB_100, BB_100, {call}, 4}));
 }
 
 TEST_F(TestPreflopAction, GetBetAmountAllIn) {
+    ASSERT_EQ(99.5, all_in->GetBetAmount({1, 0, 1, BB_100, BB_100, mt_history, 4}));
+
+    ASSERT_EQ(99, all_in->GetBetAmount({2, 0, 1, BB_100, BB_100, {min_raise}, 4}));
+
+    ASSERT_EQ(29, all_in->GetBetAmount({2, 0, 1, BB_100, 30, {min_raise}, 4}));
 }
 
 TEST_F(TestPreflopAction, Hash) {
+    const std::vector actions = {fold, check, call, min_raise, x5_raise, all_in};
+    for (size_t i = 0; i < actions.size(); ++i)
+        for (size_t j = 0; j < i; ++j)
+            EXPECT_NE(actions[i]->Hash(), actions[j]->Hash());
+
+    EXPECT_EQ(min_raise->Hash(), PreflopAction::Raise(2)->Hash());
+    EXPECT_NE(PreflopAction::Bet(2)->Hash(), min_raise->Hash());
 }
 
-// Placeholder for future IsTerminal tests
 TEST_F(TestPreflopAction, IsTerminal) {
-    // TODO: Implement terminal state tests
+    EXPECT_TRUE(fold->IsTerminal({1, 0, 1, BB_100, BB_100, mt_history, 4}));
+
+    EXPECT_FALSE(call->IsTerminal({1, 0, 1, BB_100, BB_100, mt_history, 4}))
+        << "A small blind limp leaves the big blind to act";
+
+    EXPECT_TRUE(call->IsTerminal({2, 0, 1, BB_100, BB_100, {min_raise}, 4}));
+
+    EXPECT_TRUE(check->IsTerminal({2, 0, 1, BB_100, BB_100, {call}, 4}));
+
+    EXPECT_FALSE(min_raise->IsTerminal({1, 0, 1, BB_100, BB_100, mt_history, 4}));
+
+    EXPECT_FALSE(all_in->IsTerminal({1, 0, 1, BB_100, BB_100, mt_history, 4}));
 }
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "solver/preflop/preflop_tree/preflop_tree.h"
+#include <memory>
+#include <vector>
+
+class TestPreflopTree : public testing::Test {
+protected:
+    void SetUp() override {
+        fold = PreflopAction::Fold();
+        check = PreflopAction::Check();
+        call = PreflopAction::Call();
+        min_raise = PreflopAction::Raise(2);
+        all_in = PreflopAction::AllIn();
+    }
+
+    std::shared_ptr<PreflopAction> fold, check, call, min_raise, all_in;
+};
+
+TEST_F(TestPreflopTree, PushFold) {
+    const PreflopTree tree({1, 0, 1, 10, 10, {}, 1}, {fold, all_in}, {fold, call});
+    ASSERT_EQ(5, tree.GetNumNodes());
+    EXPECT_EQ(2, tree.GetNumDecisions());
+    EXPECT_EQ(2, tree.GetMaxDepth());
+    EXPECT_EQ(2, tree.GetMaxNumActions());
+
+    // depth-first: root, SB fold, BB decision, BB fold, BB call
+    const PreflopTree::TreeNode &root = tree.GetNode(0);
+    EXPECT_EQ(PreflopTree::NodeType::DECISION, root.type);
+    EXPECT_EQ(1, root.player);
+    EXPECT_EQ(0, root.decision);
+    EXPECT_EQ(0.5, root.p1_bet);
+    EXPECT_EQ(1, root.p2_bet);
+    EXPECT_EQ(std::vector({1, 2}), std::vector(tree.GetChildren(0).begin(),
+                  tree.GetChildren(0).end()));
+    EXPECT_EQ(fold, tree.GetAction(0, 0));
+    EXPECT_EQ(all_in, tree.GetAction(0, 1));
+
+    const PreflopTree::TreeNode &folded = tree.GetNode(1);
+    EXPECT_EQ(PreflopTree::NodeType::FOLD, folded.type);
+    EXPECT_EQ(1, folded.player);
+    EXPECT_EQ(-1, folded.decision);
+    EXPECT_EQ(0, folded.num_children);
+
+    const PreflopTree::TreeNode &facing_jam = tree.GetNode(2);
+    EXPECT_EQ(2, facing_jam.player);
+    EXPECT_EQ(1, facing_jam.decision);
+    EXPECT_EQ(10, facing_jam.p1_bet);
+    EXPECT_EQ(std::vector({3, 4}), std::vector(tree.GetChildren(2).begin(),
+                  tree.GetChildren(2).end()));
+
+    EXPECT_EQ(PreflopTree::NodeType::FOLD, tree.GetNode(3).type);
+    EXPECT_EQ(2, tree.GetNode(3).player);
+
+    const PreflopTree::TreeNode &called = tree.GetNode(4);
+    EXPECT_EQ(PreflopTree::NodeType::SHOWDOWN, called.type);
+    EXPECT_TRUE(called.all_in);
+    EXPECT_EQ(10, called.p1_bet);
+    EXPECT_EQ(10, called.p2_bet);
+}
+
+TEST_F(TestPreflopTree, DepthFirstLayout) {
+    const std::vector actions = {fold, check, call, min_raise, all_in};
+    const PreflopTree tree({1, 0, 1, 100, 100, {}, 4}, actions, actions);
+
+    int num_decisions = 0;
+    for (int node = 0; node < tree.GetNumNodes(); ++node) {
+        const PreflopTree::TreeNode &tree_node = tree.GetNode(node);
+        if (tree_node.type != PreflopTree::NodeType::DECISION) {
+            EXPECT_EQ(0, tree_node.num_children);
+            EXPECT_EQ(1, tree_node.subtree_size);
+            continue;
+        }
+
+        EXPECT_EQ(num_decisions++, tree_node.decision) << "Decisions are numbered in order";
+        EXPECT_EQ(node + 1, tree.GetChildren(node)[0]) << "First child follows its parent";
+        int subtree_size = 1;
+        for (const int child: tree.GetChildren(node)) {
+            EXPECT_GT(child, node);
+            subtree_size += tree.GetNode(child).subtree_size;
+        }
+        EXPECT_EQ(subtree_size, tree_node.subtree_size);
+    }
+    EXPECT_EQ(tree.GetNumNodes(), tree.GetNode(0).subtree_size);
+    EXPECT_EQ(num_decisions, tree.GetNumDecisions());
+    EXPECT_EQ(6, tree.GetMaxDepth()) << "limp, min-raise, 3-bet, 4-bet, jam, call";
+
+    // a limped pot checked through sees a flop with chips behind
+    const int checked = tree.FindNode({call, check});
+    ASSERT_GE(checked, 0);
+    EXPECT_EQ(PreflopTree::NodeType::SHOWDOWN, tree.GetNode(checked).type);
+    EXPECT_FALSE(tree.GetNode(checked).all_in);
+
+    // actions are matched by hash, not by pointer
+    const int three_bet = tree.FindNode({PreflopAction::Raise(2), PreflopAction::Raise(2)});
+    ASSERT_GE(three_bet, 0);
+    EXPECT_EQ(1, tree.GetNode(three_bet).player);
+    EXPECT_EQ(4, tree.GetNode(three_bet).p2_bet);
+
+    EXPECT_EQ(-1, tree.FindNode({check})) << "The small blind can't check";
+    EXPECT_EQ(-1, tree.FindNode({fold, call})) << "Nothing follows a fold";
+}
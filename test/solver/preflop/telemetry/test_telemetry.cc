@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include "solver/preflop/telemetry/telemetry.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+class TestTelemetry : public testing::Test {
+protected:
+    std::string path = testing::TempDir() + "test_telemetry.jsonl";
+
+    void SetUp() override {
+        std::remove(path.c_str());
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    static TrainingTelemetry MakeTelemetry() {
+        return {100, 1.5, 66.25, 1000, 600, 0.125, 0.01, 0.5, 4096, 0.75};
+    }
+};
+
+TEST_F(TestTelemetry, ToJson) {
+    TrainingTelemetry telemetry = MakeTelemetry();
+    EXPECT_EQ("{\"iteration\":100,\"elapsed_seconds\":1.5,\"iterations_per_second\":66.25,"
+              "\"nodes_visited\":1000,\"terminal_evaluations\":600,"
+              "\"average_positive_regret\":0.125,\"strategy_change\":0.01,"
+              "\"max_strategy_change\":0.5,\"memory_usage\":4096,\"exploitability\":0.75}",
+              telemetry.ToJson());
+
+    // values JSON can't hold, and an exploitability that wasn't measured, are null
+    telemetry.iterations_per_second = INFINITY;
+    telemetry.exploitability.reset();
+    const std::string json = telemetry.ToJson();
+    EXPECT_NE(std::string::npos, json.find("\"iterations_per_second\":null,"));
+    EXPECT_NE(std::string::npos, json.find("\"exploitability\":null}"));
+}
+
+TEST_F(TestTelemetry, Log) {
+    const TrainingTelemetry telemetry = MakeTelemetry();
+    {
+        TelemetryLog log(path);
+        log.Write(telemetry);
+    }
+    // a second log appends to the first
+    TelemetryLog(path).Write(telemetry);
+
+    std::ifstream file(path);
+    std::string line;
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_TRUE(std::getline(file, line));
+        EXPECT_EQ(telemetry.ToJson(), line);
+    }
+    EXPECT_FALSE(std::getline(file, line));
+
+    EXPECT_THROW(TelemetryLog(testing::TempDir() + "missing/test_telemetry.jsonl"),
+                 std::runtime_error);
+}
@@ -0,0 +1,411 @@
+#include <gtest/gtest.h>
+#include "solver/equity/preflop_equity.h"
+#include "solver/preflop/preflop_solver.h"
+#include "solver/utils/utils.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class TestPreflopSolver : public testing::Test {
+protected:
+    void SetUp() override {
+        fold = PreflopAction::Fold();
+        check = PreflopAction::Check();
+        call = PreflopAction::Call();
+        min_raise = PreflopAction::Raise(2);
+        all_in = PreflopAction::AllIn();
+    }
+
+    std::shared_ptr<PreflopAction> fold, check, call, min_raise, all_in;
+};
+
+TEST_F(TestPreflopSolver, PushFold) {
+    // small blind (player 1) can only jam or fold 10bb deep, the big blind can only call or fold
+    PreflopSolver solver(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call});
+    solver.train(300);
+
+    const Range push = solver.get_range(1);
+    EXPECT_GT(push.Get(all_in, "AA"), 0.99);
+    EXPECT_GT(push.Get(all_in, "A2o"), 0.99);
+    EXPECT_GT(push.Get(all_in, "76s"), 0.99);
+    EXPECT_LT(push.Get(all_in, "72o"), 0.2) << "Should fold the worst hands even 10bb deep";
+    EXPECT_EQ(-1, push.Get(call, "AA")) << "Calling is not in the action space";
+    EXPECT_NEAR(1, push.Get(all_in, "KQs") + push.Get(fold, "KQs"), 1e-9);
+
+    const Range calls = solver.get_range(2);
+    EXPECT_GT(calls.Get(call, "AA"), 0.99);
+    EXPECT_GT(calls.Get(call, "A9o"), 0.99);
+    EXPECT_LT(calls.Get(call, "72o"), 0.01);
+    EXPECT_LT(calls.Get(call, "J4o"), 0.01);
+}
+
+TEST_F(TestPreflopSolver, Multithreaded) {
+    // the threads race on the shared regrets, so only the clear-cut hands are checked
+    PreflopSolver solver(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call}, {.num_threads = 4});
+    solver.train(300);
+
+    const Range push = solver.get_range(1);
+    EXPECT_GT(push.Get(all_in, "AA"), 0.99);
+    EXPECT_GT(push.Get(all_in, "A2o"), 0.99);
+    EXPECT_LT(push.Get(all_in, "72o"), 0.2);
+
+    const Range calls = solver.get_range(2);
+    EXPECT_GT(calls.Get(call, "AA"), 0.99);
+    EXPECT_LT(calls.Get(call, "72o"), 0.01);
+}
+
+TEST_F(TestPreflopSolver, SplitSubtrees) {
+    // every decision walks its children as separate tasks
+    PreflopSolver solver(20, 20, 0, 1, 2, 0.9, {fold, call, min_raise, all_in},
+                         {fold, check, call, min_raise, all_in},
+                         {.num_threads = 3, .split_threshold = 1});
+    solver.train(100);
+
+    const Range open = solver.get_range(1);
+    EXPECT_LT(open.Get(fold, "AA"), 0.01);
+    EXPECT_GT(open.Get(fold, "72o"), 0.5);
+    EXPECT_NEAR(1, open.Get(fold, "QJs") + open.Get(call, "QJs") + open.Get(min_raise, "QJs")
+                   + open.Get(all_in, "QJs"), 1e-9);
+}
+
+TEST_F(TestPreflopSolver, SampledModes) {
+    // each iteration updates one deal, so the hands need many more of them to settle
+    for (const auto mode: {TrainingMode::CHANCE_SAMPLING, TrainingMode::EXTERNAL_SAMPLING,
+                           TrainingMode::OUTCOME_SAMPLING}) {
+        PreflopSolver solver(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call},
+                             {.num_threads = 2, .mode = mode});
+        solver.train(200000);
+
+        const Range push = solver.get_range(1);
+        EXPECT_GT(push.Get(all_in, "AA"), 0.9) << static_cast<int>(mode);
+        EXPECT_GT(push.Get(all_in, "K9o"), 0.8) << static_cast<int>(mode);
+        EXPECT_LT(push.Get(all_in, "72o"), 0.5) << static_cast<int>(mode);
+
+        const Range calls = solver.get_range(2);
+        EXPECT_GT(calls.Get(call, "AA"), 0.9) << static_cast<int>(mode);
+        EXPECT_LT(calls.Get(call, "72o"), 0.2) << static_cast<int>(mode);
+    }
+}
+
+TEST_F(TestPreflopSolver, UpdateRules) {
+    // distance of each rule's jamming range after a few iterations from a converged one
+    const auto solve = [&](const UpdateRule &rule, const int num_iterations) {
+        PreflopSolver solver(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call}, {.rule = rule});
+        solver.train(num_iterations);
+        return solver.get_range(1);
+    };
+    const Range converged = solve(UpdateRule::Discounted(), 2000);
+    const auto distance = [&](const Range &range) {
+        double total = 0;
+        for (int h = 0; h < 169; ++h) {
+            const std::string hand = Utils::HandClassToString(h);
+            total += std::abs(range.Get(all_in, hand) - converged.Get(all_in, hand));
+        }
+        return total;
+    };
+
+    const double vanilla = distance(solve(UpdateRule::Vanilla(), 50));
+    EXPECT_LT(distance(solve(UpdateRule::CFRPlus(), 50)), vanilla);
+    EXPECT_LT(distance(solve(UpdateRule::Linear(), 50)), vanilla);
+    EXPECT_LT(distance(solve(UpdateRule::Discounted(), 50)), vanilla);
+    EXPECT_LT(distance(solve(UpdateRule::Discounted(), 50)), 0.5 * vanilla);
+
+    // a discount every 10 iterations still converges
+    PreflopSolver batched(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call},
+                          {.rule = UpdateRule::Discounted(), .discount_interval = 10});
+    batched.train(200);
+    EXPECT_GT(batched.get_range(1).Get(all_in, "A2o"), 0.99);
+    EXPECT_LT(batched.get_range(1).Get(all_in, "72o"), 0.2);
+}
+
+TEST_F(TestPreflopSolver, Exploitability) {
+    PreflopSolver solver(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call});
+    const double uniform = solver.get_exploitability();
+    EXPECT_GT(uniform, 0.3) << "Jamming and calling at random is easy to beat";
+
+    solver.train(300);
+    const double trained = solver.get_exploitability();
+    EXPECT_GE(trained, 0);
+    EXPECT_LT(trained, 0.01);
+
+    // the small blind loses at equilibrium, so the best responses can't both be positive
+    EXPECT_LT(solver.get_best_response_value(1), 0);
+    EXPECT_GT(solver.get_best_response_value(2), 0);
+
+    // several threads walking subtrees in parallel find the same best responses
+    PreflopSolver parallel(20, 20, 0, 1, 2, 0.9, {fold, call, min_raise, all_in},
+                           {fold, check, call, min_raise, all_in},
+                           {.num_threads = 3, .split_threshold = 1});
+    PreflopSolver serial(20, 20, 0, 1, 2, 0.9, {fold, call, min_raise, all_in},
+                         {fold, check, call, min_raise, all_in});
+    EXPECT_NEAR(serial.get_best_response_value(1), parallel.get_best_response_value(1), 1e-9);
+    EXPECT_NEAR(serial.get_best_response_value(2), parallel.get_best_response_value(2), 1e-9);
+}
+
+TEST_F(TestPreflopSolver, StoppingRule) {
+    PreflopSolver solver(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call},
+                         {.rule = UpdateRule::Discounted()});
+    const int num_iterations = solver.train(StoppingRule{.target_exploitability = 0.01,
+                                                         .check_interval = 5});
+    EXPECT_LE(solver.get_exploitability(), 0.01);
+    EXPECT_EQ(0, num_iterations % 5);
+    EXPECT_LT(num_iterations, 1000);
+
+    // an unreachable target gives way to the other limits
+    EXPECT_EQ(7, solver.train(StoppingRule{.target_exploitability = 1e-12,
+                                           .max_iterations = 7, .check_interval = 5}));
+    const auto start = std::chrono::steady_clock::now();
+    solver.train(StoppingRule{.target_exploitability = 1e-12,
+                              .time_budget = std::chrono::milliseconds(200)});
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+
+    EXPECT_THROW(solver.train(StoppingRule{}), std::invalid_argument);
+}
+
+TEST_F(TestPreflopSolver, Pruning) {
+    // 100bb deep, some lines are never worth taking with any hand
+    const std::vector p1_actions = {fold, call, min_raise, all_in};
+    const std::vector p2_actions = {fold, check, call, min_raise, all_in};
+    PreflopSolver full(100, 100, 0, 1, 3, 0.9, p1_actions, p2_actions);
+    PreflopSolver pruned(100, 100, 0, 1, 3, 0.9, p1_actions, p2_actions,
+                         {.prune_threshold = 0.05, .prune_iterations = 10});
+    full.train(100);
+    pruned.train(100);
+
+    const PruningStats stats = pruned.get_pruning_stats();
+    EXPECT_GT(stats.actions_pruned, 0);
+    EXPECT_GT(stats.subtrees_skipped, stats.actions_pruned);
+    EXPECT_GT(stats.nodes_skipped, stats.subtrees_skipped);
+    EXPECT_EQ(0, full.get_pruning_stats().nodes_skipped);
+    EXPECT_EQ(full.get_pruning_stats().nodes_walked, stats.nodes_walked + stats.nodes_skipped);
+
+    // skipping hopeless actions barely changes the solution
+    EXPECT_NEAR(full.get_exploitability(), pruned.get_exploitability(), 0.02);
+}
+
+TEST_F(TestPreflopSolver, Telemetry) {
+    // the push-fold tree has 5 nodes, 3 of them terminal
+    std::vector<TrainingTelemetry> reports;
+    const std::string path = testing::TempDir() + "test_telemetry.jsonl";
+    std::remove(path.c_str());
+    PreflopSolver solver(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call},
+                         {.telemetry_interval = 20, .telemetry_path = path,
+                          .telemetry_callback = [&](const TrainingTelemetry &telemetry) {
+                              reports.push_back(telemetry);
+                          },
+                          .telemetry_exploitability = true});
+    solver.train(50);
+    solver.train(50);
+
+    // reports fall on multiples of the interval, across calls to train
+    ASSERT_EQ(5u, reports.size());
+    for (size_t r = 0; r < reports.size(); ++r) {
+        const TrainingTelemetry &telemetry = reports[r];
+        EXPECT_EQ(20 * static_cast<int64_t>(r + 1), telemetry.iteration);
+        EXPECT_EQ(2 * 5 * telemetry.iteration, telemetry.nodes_visited);
+        EXPECT_EQ(2 * 3 * telemetry.iteration, telemetry.terminal_evaluations);
+        EXPECT_GT(telemetry.iterations_per_second, 0);
+        EXPECT_EQ(solver.get_memory_usage(), telemetry.memory_usage);
+        ASSERT_TRUE(telemetry.exploitability.has_value());
+        EXPECT_GE(*telemetry.exploitability, -1e-9);
+        EXPECT_LE(telemetry.strategy_change, telemetry.max_strategy_change);
+    }
+    EXPECT_GT(reports.back().elapsed_seconds, reports.front().elapsed_seconds);
+    // the strategies settle and the regrets per iteration fall as training converges
+    EXPECT_LT(reports.back().strategy_change, reports.front().strategy_change);
+    EXPECT_LT(reports.back().average_positive_regret, reports.front().average_positive_regret);
+    EXPECT_LT(*reports.back().exploitability, *reports.front().exploitability);
+
+    // the log holds the same reports, one per line
+    std::ifstream file(path);
+    std::string line;
+    for (const TrainingTelemetry &telemetry: reports) {
+        ASSERT_TRUE(std::getline(file, line));
+        EXPECT_EQ(telemetry.ToJson(), line);
+    }
+    EXPECT_FALSE(std::getline(file, line));
+    std::remove(path.c_str());
+
+    // the sampling walks count the nodes they visit; outcome sampling walks a single path
+    PreflopSolver sampled(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call},
+                          {.mode = TrainingMode::OUTCOME_SAMPLING, .telemetry_interval = 100,
+                           .telemetry_callback = [&](const TrainingTelemetry &telemetry) {
+                               reports.push_back(telemetry);
+                           }});
+    sampled.train(100);
+    EXPECT_FALSE(reports.back().exploitability.has_value());
+    EXPECT_GE(reports.back().nodes_visited, 2 * 2 * 100);
+    EXPECT_LE(reports.back().nodes_visited, 2 * 3 * 100);
+    EXPECT_EQ(2 * 100, reports.back().terminal_evaluations);
+
+    EXPECT_THROW(PreflopSolver(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call},
+                               {.telemetry_interval = 10}), std::invalid_argument);
+}
+
+TEST_F(TestPreflopSolver, GetRangeHistory) {
+    PreflopSolver solver(20, 20, 0, 1, 2, 0.9, {fold, call, min_raise, all_in},
+                         {fold, check, call, min_raise, all_in});
+    solver.train(20);
+
+    // after a limp the big blind can check, raise or jam, but not fold or call
+    const Range limped = solver.get_range(2, {call});
+    EXPECT_EQ(-1, limped.Get(fold, "AA"));
+    EXPECT_NEAR(1, limped.Get(check, "T9s") + limped.Get(min_raise, "T9s")
+                   + limped.Get(all_in, "T9s"), 1e-9);
+
+    // after a min-raise and a 3-bet, the small blind has used up the raises
+    const Range three_bet = solver.get_range(1, {min_raise, min_raise});
+    EXPECT_EQ(-1, three_bet.Get(all_in, "AA"));
+    EXPECT_NEAR(1, three_bet.Get(fold, "AA") + three_bet.Get(call, "AA"), 1e-9);
+
+    EXPECT_THROW(three_bet.Get(fold, "AAs"), std::invalid_argument);
+    EXPECT_THROW(solver.get_range(1, {call}), std::invalid_argument)
+        << "The big blind acts after a limp";
+    EXPECT_THROW(solver.get_range(2, {fold}), std::invalid_argument)
+        << "Nobody acts after a fold";
+}
+
+TEST_F(TestPreflopSolver, ZeroSum) {
+    // limping and checking down with full equity realization is worth nothing to either player
+    // on average, so the small blind should prefer it to folding with any hand
+    PreflopSolver solver(50, 50, 0, 1, 1, 1, {fold, call}, {check});
+    solver.train(10);
+
+    const Range limps = solver.get_range(1);
+    EXPECT_GT(limps.Get(call, "72o"), 0.9);
+    EXPECT_GT(limps.Get(call, "AA"), 0.9);
+}
+
+TEST_F(TestPreflopSolver, FloatPrecision) {
+    PreflopSolver doubles(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call});
+    PreflopSolver floats(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call},
+                         {.precision = InfosetStore::Precision::FLOAT});
+    EXPECT_LT(floats.get_memory_usage(), doubles.get_memory_usage());
+
+    doubles.train(100);
+    floats.train(100);
+    for (const std::string hand: {"AA", "K9o", "T8s", "64s", "Q2o"})
+        EXPECT_NEAR(doubles.get_range(1).Get(all_in, hand), floats.get_range(1).Get(all_in, hand),
+                    1e-3) << hand;
+}
+
+TEST_F(TestPreflopSolver, FixedPointPrecision) {
+    PreflopSolver doubles(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call});
+    doubles.train(100);
+    for (const auto precision: {InfosetStore::Precision::FIXED32,
+                                InfosetStore::Precision::FIXED16}) {
+        PreflopSolver fixed(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call},
+                            {.precision = precision});
+        EXPECT_LT(fixed.get_memory_usage(), doubles.get_memory_usage() / 2);
+        fixed.train(100);
+        EXPECT_NEAR(doubles.get_exploitability(), fixed.get_exploitability(), 0.01);
+        for (const std::string hand: {"AA", "K9o", "T8s", "64s", "Q2o"})
+            EXPECT_NEAR(doubles.get_range(1).Get(all_in, hand),
+                        fixed.get_range(1).Get(all_in, hand), 0.05) << hand;
+    }
+
+    EXPECT_THROW(PreflopSolver(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call},
+                               {.precision = InfosetStore::Precision::FIXED16, .num_threads = 2}),
+                 std::invalid_argument);
+}
+
+TEST_F(TestPreflopSolver, EquityTable) {
+    // a made-up table in which 72o wins every showdown and the other matchups are even
+    const std::string path = testing::TempDir() + "test_preflop_solver_equity.bin";
+    const int worst = Utils::ParseHandClass("72o");
+    std::vector<float> classes(169 * 169, 0.5f);
+    for (int h = 0; h < 169; ++h)
+        if (h != worst) {
+            classes[worst * 169 + h] = 1;
+            classes[h * 169 + worst] = 0;
+        }
+    PreflopEquityTable(classes).Save(path);
+
+    PreflopSolver solver(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call},
+                         {.equity_table = path});
+    std::remove(path.c_str());
+    solver.train(300);
+    EXPECT_GT(solver.get_range(1).Get(all_in, "72o"), 0.99);
+    EXPECT_GT(solver.get_range(2).Get(call, "72o"), 0.99);
+
+    EXPECT_THROW(PreflopSolver(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call},
+                               {.equity_table = path}), std::runtime_error);
+}
+
+TEST_F(TestPreflopSolver, Checkpoint) {
+    const std::string path = testing::TempDir() + "test_preflop_solver_checkpoint.bin";
+    const SolverOptions options = {.rule = UpdateRule::Discounted(), .checkpoint_path = path,
+                                   .checkpoint_interval = 20};
+    PreflopSolver solver(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call}, options);
+    solver.train(50);
+    solver.wait_for_checkpoints();
+
+    // the last checkpoint was taken after 40 iterations; train the original up to the same
+    // point as the resumed one, and they should match to the last bit
+    PreflopSolver resumed(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call},
+                          {.rule = UpdateRule::Discounted()});
+    resumed.resume(path);
+    EXPECT_EQ(40, resumed.get_num_iterations());
+    resumed.train(30);
+    // this queues the checkpoint at 60 iterations, which must be written before the file is read
+    // or removed below
+    solver.train(20);
+    solver.wait_for_checkpoints();
+    for (const std::string hand: {"AA", "K9o", "T8s", "64s", "Q2o"}) {
+        EXPECT_EQ(solver.get_range(1).Get(all_in, hand), resumed.get_range(1).Get(all_in, hand))
+            << hand;
+        EXPECT_EQ(solver.get_range(2).Get(call, hand), resumed.get_range(2).Get(call, hand))
+            << hand;
+    }
+
+    PreflopSolver deeper(20, 20, 0, 1, 1, 1, {fold, all_in}, {fold, call});
+    EXPECT_THROW(deeper.resume(path), std::invalid_argument) << "Different game";
+    PreflopSolver wider(10, 10, 0, 1, 1, 1, {fold, call, all_in}, {fold, check, call});
+    EXPECT_THROW(wider.resume(path), std::invalid_argument) << "Different tree";
+    PreflopSolver floats(10, 10, 0, 1, 1, 1, {fold, all_in}, {fold, call},
+                         {.precision = InfosetStore::Precision::FLOAT});
+    EXPECT_THROW(floats.resume(path), std::invalid_argument) << "Different precision";
+    std::remove(path.c_str());
+}
+
+TEST_F(TestPreflopSolver, WarmStart) {
+    // a neighbour in a sweep over stack depths and equity realization
+    PreflopSolver prior(20, 20, 0, 1, 2, 0.9, {fold, call, min_raise, all_in},
+                        {fold, check, call, min_raise, all_in});
+    prior.train(300);
+
+    const auto make = [&] {
+        return std::make_unique<PreflopSolver>(25, 25, 0, 1, 2, 0.85,
+                                               std::vector{fold, call, min_raise, all_in},
+                                               std::vector{fold, check, call, min_raise, all_in});
+    };
+    const auto cold = make(), warm = make();
+    cold->train(100);
+    warm->warm_start(prior);
+    warm->train(30);
+    EXPECT_LT(warm->get_exploitability(), cold->get_exploitability())
+        << "Should converge in a fraction of the iterations";
+
+    // from a checkpoint of a tree in which the big blind can't min-raise
+    const std::string path = testing::TempDir() + "test_preflop_solver_warm_start.bin";
+    PreflopSolver narrow(20, 20, 0, 1, 2, 0.9, {fold, call, min_raise, all_in},
+                         {fold, check, call, all_in});
+    narrow.train(300);
+    narrow.save_checkpoint(path);
+    const auto from_checkpoint = make(), fresh = make();
+    from_checkpoint->warm_start(path);
+    std::remove(path.c_str());
+    from_checkpoint->train(30);
+    fresh->train(30);
+    EXPECT_LT(from_checkpoint->get_exploitability(), fresh->get_exploitability());
+    EXPECT_EQ(30, from_checkpoint->get_num_iterations());
+
+    // a solver that has trained starts over
+    cold->warm_start(prior);
+    EXPECT_EQ(0, cold->get_num_iterations());
+}
@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include "solver/preflop/update_rule/update_rule.h"
+
+TEST(TestUpdateRule, Vanilla) {
+    const UpdateRule rule = UpdateRule::Vanilla();
+    EXPECT_FALSE(rule.Discounts());
+    for (const int t: {1, 2, 1000}) {
+        EXPECT_EQ(1, rule.GetPositiveRegretDiscount(t));
+        EXPECT_EQ(1, rule.GetNegativeRegretDiscount(t));
+        EXPECT_EQ(1, rule.GetStrategyDiscount(t));
+    }
+}
+
+TEST(TestUpdateRule, CFRPlus) {
+    const UpdateRule rule = UpdateRule::CFRPlus();
+    EXPECT_TRUE(rule.Discounts());
+    EXPECT_EQ(1, rule.GetPositiveRegretDiscount(3));
+    EXPECT_EQ(0, rule.GetNegativeRegretDiscount(3)) << "Negative regrets are floored at 0";
+    EXPECT_DOUBLE_EQ(0.75, rule.GetStrategyDiscount(3));
+}
+
+TEST(TestUpdateRule, Linear) {
+    // after T iterations, iteration t's contribution has been scaled by t / T
+    const UpdateRule rule = UpdateRule::Linear();
+    double weight = 1;
+    for (int t = 2; t < 10; ++t)
+        weight *= rule.GetStrategyDiscount(t);
+    EXPECT_DOUBLE_EQ(2.0 / 10, weight);
+    EXPECT_DOUBLE_EQ(0.5, rule.GetPositiveRegretDiscount(1));
+    EXPECT_DOUBLE_EQ(0.75, rule.GetNegativeRegretDiscount(3));
+}
+
+TEST(TestUpdateRule, Discounted) {
+    const UpdateRule rule = UpdateRule::Discounted();
+    EXPECT_DOUBLE_EQ(8.0 / 9, rule.GetPositiveRegretDiscount(4)) << "4^1.5 / (4^1.5 + 1)";
+    EXPECT_DOUBLE_EQ(0.5, rule.GetNegativeRegretDiscount(4));
+    EXPECT_DOUBLE_EQ(0.64, rule.GetStrategyDiscount(4));
+
+    const UpdateRule custom = UpdateRule::Discounted(2, 1, 0);
+    EXPECT_DOUBLE_EQ(0.8, custom.GetPositiveRegretDiscount(2));
+    EXPECT_EQ(1, custom.GetStrategyDiscount(2));
+}
@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+#include "solver/utils/dealer.h"
+#include "solver/utils/rng.h"
+#include "solver/utils/utils.h"
+#include <bit>
+#include <vector>
+
+TEST(TestDealer, DealsLiveCards) {
+    const u64 dead = Utils::CardsToMask(Utils::ParseCards("AhAsKd"));
+    const u64 exclude = Utils::CardsToMask(Utils::ParseCards("2c3c"));
+    Dealer dealer(dead);
+    Rng rng(5);
+    EXPECT_EQ(49, dealer.GetSize());
+
+    std::vector<int> counts(Utils::NUM_CARDS);
+    for (int k = 0; k < 20000; ++k) {
+        const u64 dealt = dealer.Deal(rng, 5, exclude);
+        ASSERT_EQ(5, std::popcount(dealt)) << "cards should be distinct";
+        ASSERT_EQ(0u, dealt & (dead | exclude)) << "dealt a dead or excluded card";
+        for (u64 mask = dealt; mask; mask &= mask - 1)
+            ++counts[std::countr_zero(mask)];
+    }
+
+    // 100000 cards over 47 live cards
+    for (int i = 0; i < Utils::NUM_CARDS; ++i)
+        if (!((dead | exclude) >> i & 1)) {
+            EXPECT_NEAR(100000.0 / 47, counts[i], 250) << "card " << i << " dealt unevenly";
+        }
+
+    std::array<u32, 3> cards{};
+    dealer.Deal(rng, cards);
+    EXPECT_EQ(3, std::popcount(Utils::CardsToMask(cards)));
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include "solver/utils/hand_indexer.h"
+#include "solver/utils/utils.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST(TestHandIndexer, Sizes) {
+    EXPECT_EQ(169u, HandIndexer::Preflop().GetSize());
+    EXPECT_EQ(1286792u, HandIndexer::Flop().GetSize());
+    EXPECT_EQ(55190538u, HandIndexer::Turn().GetSize());
+    EXPECT_EQ(2428287420u, HandIndexer::River().GetSize());
+
+    // the board as one round
+    EXPECT_EQ(13960050u, HandIndexer({2, 4}).GetSize());
+    EXPECT_EQ(123156254u, HandIndexer({2, 5}).GetSize());
+}
+
+TEST(TestHandIndexer, Isomorphic) {
+    const HandIndexer flop = HandIndexer::Flop();
+    const auto index = [&](const std::string& cards) {
+        return flop.Index(Utils::ParseCards(cards));
+    };
+    EXPECT_EQ(index("AhKhQh7d2d"), index("KsAsQs2c7c"));
+    EXPECT_NE(index("AhKhQh7d2d"), index("AhKhQd7h2d"));
+    // hole cards and board are different rounds
+    EXPECT_NE(index("AhKdQh7d2d"), index("AhQhKd7d2d"));
+
+    EXPECT_THROW(static_cast<void>(index("AhKh")), std::invalid_argument);
+    EXPECT_THROW(static_cast<void>(index("AhAhQh7d2d")), std::invalid_argument);
+}
+
+TEST(TestHandIndexer, Preflop) {
+    // one index per hand class
+    const HandIndexer preflop = HandIndexer::Preflop();
+    std::vector<int> class_of_index(preflop.GetSize(), -1);
+    for (int combo = 0; combo < Utils::NUM_COMBOS; ++combo) {
+        auto [i, j] = Utils::ComboToIndices(combo);
+        const std::vector cards = {Utils::IndexToCard(i), Utils::IndexToCard(j)};
+        const u64 index = preflop.Index(cards);
+        if (class_of_index[index] == -1)
+            class_of_index[index] = Utils::ComboToHandClass(combo);
+        EXPECT_EQ(class_of_index[index], Utils::ComboToHandClass(combo));
+    }
+}
+
+TEST(TestHandIndexer, FlopRoundTrip) {
+    // every flop index is hit by its canonical hand
+    const HandIndexer flop = HandIndexer::Flop();
+    for (u64 index = 0; index < flop.GetSize(); ++index)
+        ASSERT_EQ(index, flop.Index(flop.Unindex(index))) << "WA on " << index;
+}
+
+TEST(TestHandIndexer, RandomRoundTrip) {
+    std::vector<u32> deck = Utils::MakeDeck();
+    std::mt19937 rng(11);
+    for (const auto& [indexer, num_cards]: {std::pair(HandIndexer::Turn(), 6),
+                                            std::pair(HandIndexer::River(), 7),
+                                            std::pair(HandIndexer({2, 5}), 7)}) {
+        for (int t = 0; t < 20000; ++t) {
+            std::ranges::shuffle(deck, rng);
+            const std::vector hand(deck.begin(), deck.begin() + num_cards);
+            const u64 index = indexer.Index(hand);
+            ASSERT_LT(index, indexer.GetSize());
+            ASSERT_EQ(index, indexer.Index(indexer.Unindex(index)));
+
+            // relabelling the suits keeps the index
+            std::vector<u32> relabelled;
+            for (const u32 card: hand) {
+                const int i = Utils::CardToIndex(card);
+                relabelled.push_back(Utils::IndexToCard(i - i % 4 + (3 - i % 4)));
+            }
+            ASSERT_EQ(index, indexer.Index(relabelled));
+        }
+    }
+}
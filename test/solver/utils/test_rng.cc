@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "solver/utils/rng.h"
+#include <algorithm>
+#include <vector>
+
+TEST(TestRng, Reproducible) {
+    Rng a(123), b(123), c(124);
+    bool all_equal = true;
+    for (int k = 0; k < 100; ++k) {
+        const uint64_t x = a.Next();
+        EXPECT_EQ(x, b.Next());
+        all_equal &= x == c.Next();
+    }
+    EXPECT_FALSE(all_equal) << "different seeds should give different sequences";
+}
+
+TEST(TestRng, Below) {
+    Rng rng(7);
+    std::vector<int> counts(10);
+    for (int k = 0; k < 100000; ++k) {
+        const uint32_t x = rng.Below(10);
+        ASSERT_LT(x, 10u);
+        ++counts[x];
+    }
+    for (const int count: counts)
+        EXPECT_NEAR(10000, count, 500) << "Below should be uniform";
+
+    EXPECT_EQ(0u, rng.Below(1));
+    const double d = rng.NextDouble();
+    EXPECT_TRUE(d >= 0 && d < 1);
+}
+
+TEST(TestRng, Split) {
+    Rng rng(99);
+    Rng copy = rng;
+    Rng first = rng.Split();
+    Rng second = rng.Split();
+
+    // the first stream continues where the generator was; the second starts elsewhere
+    std::vector<uint64_t> xs, ys;
+    for (int k = 0; k < 50; ++k) {
+        const uint64_t x = first.Next();
+        EXPECT_EQ(copy.Next(), x);
+        xs.push_back(x);
+        ys.push_back(second.Next());
+    }
+    std::ranges::sort(xs);
+    for (const uint64_t y: ys)
+        EXPECT_FALSE(std::ranges::binary_search(xs, y)) << "streams should not overlap";
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "solver/utils/task_scheduler.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Sum of the nodes of a complete binary tree of a given depth, one task per subtree.
+static long long CountNodes(TaskScheduler& scheduler, const int depth) {
+    if (depth == 0)
+        return 1;
+
+    long long left = 0;
+    TaskScheduler::TaskGroup group(scheduler);
+    group.Spawn([&](int) { left = CountNodes(scheduler, depth - 1); });
+    const long long right = CountNodes(scheduler, depth - 1);
+    group.Wait();
+    return 1 + left + right;
+}
+
+TEST(TestTaskScheduler, ParallelFor) {
+    TaskScheduler scheduler(4);
+    EXPECT_EQ(4, scheduler.GetNumThreads());
+
+    // run twice to check the workers pick up a second loop
+    for (int round = 0; round < 2; ++round) {
+        std::vector<int> done(1000);
+        std::vector<long long> per_thread(scheduler.GetNumThreads());
+        scheduler.ParallelFor(done.size(), [&](const size_t task, const int thread) {
+            ++done[task];
+            per_thread[thread] += static_cast<long long>(task);
+        });
+
+        for (const int count: done)
+            ASSERT_EQ(1, count) << "every task should run exactly once";
+        long long sum = 0;
+        for (const long long s: per_thread) sum += s;
+        EXPECT_EQ(999 * 1000 / 2, sum);
+    }
+}
+
+TEST(TestTaskScheduler, NestedTasks) {
+    TaskScheduler scheduler(3);
+    long long count = 0;
+    scheduler.Run([&](int) { count = CountNodes(scheduler, 12); });
+    EXPECT_EQ((1 << 13) - 1, count);
+
+    // tasks spawned inside a loop body are stolen too
+    std::atomic<long long> total = 0;
+    scheduler.ParallelFor(8, [&](size_t, int) { total += CountNodes(scheduler, 6); });
+    EXPECT_EQ(8 * 127, total);
+
+    // outside Run, spawned tasks run right away
+    EXPECT_EQ(127, CountNodes(scheduler, 6));
+}
+
+TEST(TestTaskScheduler, Exception) {
+    TaskScheduler scheduler(3);
+    EXPECT_THROW(scheduler.Run([&](int) {
+        TaskScheduler::TaskGroup group(scheduler);
+        for (int i = 0; i < 100; ++i)
+            group.Spawn([i](int) { if (i == 42) throw std::runtime_error("task failed"); });
+        group.Wait();
+    }), std::runtime_error);
+    EXPECT_THROW(scheduler.ParallelFor(100, [](const size_t task, int) {
+        if (task == 42) throw std::runtime_error("task failed");
+    }), std::runtime_error);
+
+    std::atomic<int> count = 0;
+    scheduler.ParallelFor(10, [&](size_t, int) { ++count; });
+    EXPECT_EQ(10, count) << "the scheduler should still work after an exception";
+}
+
+TEST(TestTaskScheduler, IdleThreadsSleep) {
+    TaskScheduler scheduler(4);
+    std::mutex mutex;
+    std::set<int> threads;
+    scheduler.Run([&](int) {
+        // long enough for the other threads to stop spinning and go to sleep
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        TaskScheduler::TaskGroup group(scheduler);
+        for (int i = 0; i < 8; ++i)
+            group.Spawn([&](const int thread) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                std::lock_guard lock(mutex);
+                threads.insert(thread);
+            });
+        group.Wait();
+    });
+    EXPECT_GT(threads.size(), 1u) << "spawning tasks should wake the sleeping threads";
+}
+
+TEST(TestTaskScheduler, ScratchArena) {
+    ScratchArena arena;
+    const ScratchArena::Mark start = arena.GetMark();
+    const std::span<double> a = arena.Allocate(10);
+    const ScratchArena::Mark mark = arena.GetMark();
+    const std::span<double> b = arena.Allocate(20);
+    EXPECT_EQ(a.data() + 10, b.data()) << "buffers are handed out in stack order";
+
+    arena.Release(mark);
+    EXPECT_EQ(b.data(), arena.Allocate(5).data()) << "released space is reused";
+
+    // a buffer larger than a chunk gets its own, and is reused after release too
+    arena.Release(start);
+    const std::span<double> large = arena.Allocate(1 << 20);
+    EXPECT_EQ(1u << 20, large.size());
+    large[(1 << 20) - 1] = 1;
+    arena.Release(start);
+    EXPECT_EQ(a.data(), arena.Allocate(10).data());
+    EXPECT_EQ(large.data(), arena.Allocate(1 << 20).data());
+}
@@ -54,6 +54,29 @@ TEST_F(TestUtils, CardToString) {
     EXPECT_THROW(Utils::CardToString(393216), std::invalid_argument);
 }
 
+TEST_F(TestUtils, HandClasses) {
+    EXPECT_EQ(12 * 13 + 12, Utils::ParseHandClass("AA"));
+    EXPECT_EQ(12 * 13 + 11, Utils::ParseHandClass("AKs"));
+    EXPECT_EQ(11 * 13 + 12, Utils::ParseHandClass("AKo"));
+    EXPECT_EQ(Utils::ParseHandClass("76o"), Utils::ParseHandClass("67o"));
+    EXPECT_THROW(Utils::ParseHandClass("AAs"), std::invalid_argument);
+    EXPECT_THROW(Utils::ParseHandClass("AK"), std::invalid_argument);
+
+    // every class round-trips and the combos split into classes of the right sizes
+    std::vector<int> sizes(Utils::NUM_HAND_CLASSES);
+    for (int combo = 0; combo < Utils::NUM_COMBOS; ++combo)
+        ++sizes[Utils::ComboToHandClass(combo)];
+    for (int hand_class = 0; hand_class < Utils::NUM_HAND_CLASSES; ++hand_class) {
+        EXPECT_EQ(hand_class, Utils::ParseHandClass(Utils::HandClassToString(hand_class)));
+        EXPECT_EQ(Utils::HandClassSize(hand_class), sizes[hand_class])
+            << "WA on " << Utils::HandClassToString(hand_class);
+    }
+
+    const int combo = Utils::ComboIndex(Utils::CardToIndex(Utils::ParseCard("7h")),
+                                        Utils::CardToIndex(Utils::ParseCard("6h")));
+    EXPECT_EQ("76s", Utils::HandClassToString(Utils::ComboToHandClass(combo)));
+}
+
 TEST_F(TestUtils, MakeDeck) {
     const std::vector<u32> deck = Utils::MakeDeck();
     std::vector<std::string> deck_strings;
@@ -77,4 +100,34 @@ TEST_F(TestUtils, Shuffle) {
 
     Utils::Shuffle(shuffled);
     EXPECT_NE(deck, shuffled) << "shuffle didn't shuffle";
-}
\ No newline at end of file
+}
+
+TEST_F(TestUtils, CardToIndex) {
+    EXPECT_EQ(0, Utils::CardToIndex(Utils::ParseCard("2s"))) << "index WA on 2s";
+    EXPECT_EQ(7, Utils::CardToIndex(Utils::ParseCard("3c"))) << "index WA on 3c";
+    EXPECT_EQ(49, Utils::CardToIndex(Utils::ParseCard("Ah"))) << "index WA on Ah";
+
+    std::vector<bool> seen(Utils::NUM_CARDS);
+    for (const u32 card: Utils::MakeDeck()) {
+        const int index = Utils::CardToIndex(card);
+        EXPECT_EQ(card, Utils::IndexToCard(index))
+            << "round trip WA on " << Utils::CardToString(card);
+        seen[index] = true;
+    }
+    EXPECT_EQ(std::vector(Utils::NUM_CARDS, true), seen) << "indices are not a bijection";
+
+    EXPECT_EQ(0b10000001ULL, Utils::CardsToMask(Utils::ParseCards("2s3c"))) << "mask WA on 2s3c";
+}
+
+TEST_F(TestUtils, ComboIndex) {
+    std::vector<bool> seen(Utils::NUM_COMBOS);
+    for (int i = 0; i < Utils::NUM_CARDS; ++i) {
+        for (int j = 0; j < i; ++j) {
+            const int combo = Utils::ComboIndex(i, j);
+            ASSERT_EQ(combo, Utils::ComboIndex(j, i)) << "WA on " << i << ", " << j;
+            ASSERT_EQ(std::make_pair(i, j), Utils::ComboToIndices(combo)) << "WA on " << combo;
+            seen[combo] = true;
+        }
+    }
+    EXPECT_EQ(std::vector(Utils::NUM_COMBOS, true), seen) << "combos are not a bijection";
+}
@@ -0,0 +1,48 @@
+#include "solver/equity/equity.h"
+#include "solver/equity/preflop_equity.h"
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Computes the preflop equity table and saves it for PreflopEquityTable::Load.
+//
+// usage: gen_preflop_equity <output file> [--combos] [--threads N]
+//   --combos     also store the 1326x1326 combo table (about 7 MB)
+//   --threads N  threads to enumerate boards on (default: one per hardware thread)
+
+int main(const int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <output file> [--combos] [--threads N]" << std::endl;
+        return 1;
+    }
+
+    const std::string path = argv[1];
+    bool with_combos = false;
+    int num_threads = 0;
+    for (int i = 2; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--combos")) {
+            with_combos = true;
+        } else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+            num_threads = std::stoi(argv[++i]);
+        } else {
+            std::cerr << "unknown argument " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    const EquityCalculator calculator(num_threads);
+    int last_percent = -1;
+    const PreflopEquityTable table = PreflopEquityTable::Compute(
+        calculator, with_combos, [&](const size_t done, const size_t total) {
+            const int percent = static_cast<int>(100 * done / total);
+            if (percent != last_percent) {
+                last_percent = percent;
+                std::cerr << "\r" << percent << "% of " << total << " matchups" << std::flush;
+            }
+        });
+    std::cerr << std::endl;
+
+    table.Save(path);
+    std::cout << "wrote " << path << std::endl;
+    return 0;
+}